@@ -1,25 +1,99 @@
+#include <chrono>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 
-BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager)
-        : pool_size_(pool_size), disk_manager_(disk_manager) {
+BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, ReplacerType replacer_type)
+        : pool_size_(pool_size), disk_manager_(disk_manager), io_pending_(pool_size, false),
+          write_pending_(pool_size, false), dirtied_while_writing_(pool_size, false) {
   pages_ = new Page[pool_size_];
-  replacer_ = new LRUReplacer(pool_size_);
+  switch (replacer_type) {
+    case ReplacerType::kClock:
+      replacer_ = new ClockReplacer(pool_size_);
+      break;
+    case ReplacerType::kLRUK:
+      replacer_ = new LRUKReplacer(pool_size_, DEFAULT_LRUK_REPLACER_K);
+      break;
+    case ReplacerType::kLRU:
+    default:
+      replacer_ = new LRUReplacer(pool_size_);
+      break;
+  }
   for (size_t i = 0; i < pool_size_; i++) {
     free_list_.emplace_back(i);
   }
+  flusher_ = std::thread(&BufferPoolManager::FlusherLoop, this);
 }
 
+BufferPoolManager::BufferPoolManager(DiskManager *disk_manager)
+        : pool_size_(0), pages_(nullptr), disk_manager_(disk_manager), replacer_(nullptr) {}
+
 BufferPoolManager::~BufferPoolManager() {
-  for (auto page: page_table_) {
-    FlushPage(page.first);
+  StopPrefetch();
+  if (flusher_.joinable()) {
+    {
+      std::scoped_lock<std::mutex> lock(flusher_mutex_);
+      stop_flusher_ = true;
+    }
+    flusher_cv_.notify_one();
+    flusher_.join();
   }
+  FlushAllPages();
   delete[] pages_;
   delete replacer_;
 }
 
-Page *BufferPoolManager::FetchPage(page_id_t page_id) {
+frame_id_t BufferPoolManager::GetVictimFrame() {
+  frame_id_t frame_id;
+  if (!free_list_.empty()) {
+    frame_id = free_list_.front();
+    free_list_.pop_front();
+    return frame_id;
+  }
+  if (!replacer_->Victim(&frame_id)) {
+    return INVALID_FRAME_ID;
+  }
+  // the frame itself remembers which page it holds, no need to search the page table
+  // the flusher keeps most unpinned pages clean, so this synchronous write is the uncommon case
+  Page &victim = pages_[frame_id];
+  if (victim.IsDirty() && !disk_manager_->WritePage(victim.page_id_, victim.GetData())) {
+    // the only copy of the page is in the frame, it stays there and can be picked again later
+    replacer_->Unpin(frame_id);
+    return INVALID_FRAME_ID;
+  }
+  page_table_.erase(victim.page_id_);
+  return frame_id;
+}
+
+frame_id_t BufferPoolManager::GetStrategyFrame(BufferAccessStrategy *strategy, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(strategy->latch_);
+  auto &slot = strategy->ring_[strategy->current_];
+  strategy->current_ = (strategy->current_ + 1) % strategy->ring_.size();
+  frame_id_t frame_id = INVALID_FRAME_ID;
+  if (slot.owner_ == this && pages_[slot.frame_id_].page_id_ == slot.page_id_
+      && pages_[slot.frame_id_].pin_count_ == 0) {
+    frame_id = slot.frame_id_;
+    Page &victim = pages_[frame_id];
+    if (victim.IsDirty() && !disk_manager_->WritePage(victim.page_id_, victim.GetData())) {
+      // the page stays in its frame, like a victim of GetVictimFrame
+      return INVALID_FRAME_ID;
+    }
+    replacer_->Remove(frame_id);
+    page_table_.erase(victim.page_id_);
+  } else {
+    frame_id = GetVictimFrame();
+  }
+  if (frame_id != INVALID_FRAME_ID) {
+    slot.owner_ = this;
+    slot.frame_id_ = frame_id;
+    slot.page_id_ = page_id;
+  }
+  return frame_id;
+}
+
+Page *BufferPoolManager::FetchPage(page_id_t page_id, BufferAccessStrategy *strategy) {
     // 1.     Search the page table for the requested page (P).
     // 1.1    If P exists, pin it and return it immediately.
     // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
@@ -27,92 +101,73 @@ Page *BufferPoolManager::FetchPage(page_id_t page_id) {
     // 2.     If R is dirty, write it back to the disk.
     // 3.     Delete R from the page table and insert P.
     // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
-    unordered_map<page_id_t, frame_id_t> ::iterator page_it;
-    page_it = page_table_.find(page_id);
-    if(page_it != page_table_.end())
-    {
-        replacer_->Pin(page_it->second);
-        pages_[page_it->second].pin_count_++;
-        return &pages_[page_it->second];
-    }//search the table
-
-    else
-    {
-        frame_id_t targetR;
-        if(!free_list_.empty())
-        {
-            targetR = free_list_.front();
-            free_list_.pop_front();
-        }
-        else if(!replacer_->Victim(&targetR))
-            return nullptr;
-        page_it = page_table_.begin();
-        while(page_it!=page_table_.end())
-        {
-            if (page_it->second == targetR)
-                break;
-            else
-                page_it++;
-        }
-        //得到符合要求的page
-        if(pages_[targetR].IsDirty())
-            disk_manager_->WritePage(page_it->first,pages_[targetR].GetData());
-        disk_manager_->ReadPage(page_id,pages_[targetR].data_);
-        pages_[targetR].page_id_ = page_id;
-        pages_[targetR].is_dirty_ = true;
-        pages_[targetR].pin_count_ = 1;
-        page_table_.insert(pair<page_id_t, frame_id_t>(page_id,targetR));
-        if(page_it!=page_table_.end()){
-            page_table_.erase(page_it);
-        }
-        //uint32_t *data = reinterpret_cast<uint32_t *>(disk_manager_->GetMetaData());
-
-        return &pages_[targetR];
+    std::unique_lock<std::recursive_mutex> lock(latch_);
+    auto page_it = page_table_.find(page_id);
+    // a prefetch is still reading the page, wait for it and look again since the frame may be evicted meanwhile
+    while (page_it != page_table_.end() && io_pending_[page_it->second]) {
+      io_cv_.wait(lock);
+      page_it = page_table_.find(page_id);
+    }
+    if (page_it != page_table_.end()) {
+      replacer_->RecordAccess(page_it->second);
+      replacer_->Pin(page_it->second);
+      pages_[page_it->second].pin_count_++;
+      return &pages_[page_it->second];
     }
+    frame_id_t targetR = strategy == nullptr ? GetVictimFrame() : GetStrategyFrame(strategy, page_id);
+    if (targetR == INVALID_FRAME_ID) {
+      return nullptr;
+    }
+    // on an I/O error the frame goes back to the free list, a zeroed page must not be served in place of the data
+    if (!disk_manager_->ReadPage(page_id, pages_[targetR].data_)) {
+      pages_[targetR].page_id_ = INVALID_PAGE_ID;
+      free_list_.push_front(targetR);
+      return nullptr;
+    }
+    replacer_->RecordAccess(targetR);
+    pages_[targetR].page_id_ = page_id;
+    pages_[targetR].is_dirty_ = false;
+    pages_[targetR].pin_count_ = 1;
+    page_table_.emplace(page_id, targetR);
+    return &pages_[targetR];
+}
 
-    return nullptr;
+Page *BufferPoolManager::NewPageAt(page_id_t page_id) {
+    frame_id_t targetR = GetVictimFrame();
+    if (targetR == INVALID_FRAME_ID) {
+      return nullptr;
+    }
+    replacer_->RecordAccess(targetR);
+    pages_[targetR].ResetMemory();
+    pages_[targetR].page_id_ = page_id;
+    pages_[targetR].is_dirty_ = false;
+    pages_[targetR].pin_count_ = 1;
+    page_table_.emplace(page_id, targetR);
+    return &pages_[targetR];
 }
 
-Page *BufferPoolManager::NewPage(page_id_t &page_id) {
+Page *BufferPoolManager::NewPage(page_id_t &page_id, extent_owner_t owner_id) {
     // 0.   Make sure you call AllocatePage!
     // 1.   If all the pages in the buffer pool are pinned, return nullptr.
     // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
     // 3.   Update P's metadata, zero out memory and add P to the page table.
     // 4.   Set the page ID output parameter. Return a pointer to P.
-    size_t i;
-    for (i = 0; i < pool_size_; ++i) {
-        if(pages_[i].pin_count_ == 0)
-            break ;
-    }
-    if(i == pool_size_)
-        return nullptr;
-    else
-    {
-        unordered_map<page_id_t, frame_id_t> ::iterator page_it;
-        page_id = disk_manager_->AllocatePage();
-        frame_id_t targetR;
-        if(!free_list_.empty()) {targetR = free_list_.front();free_list_.pop_front();}
-        else if(!replacer_->Victim(&targetR)) return nullptr;
-        page_it = page_table_.begin();
-        while(page_it!=page_table_.end()){
-            if (page_it->second == targetR)
-                break;
-            else
-                page_it++;
-        }
-        //得到符合要求的page
-        if(pages_[targetR].IsDirty())
-            disk_manager_->WritePage(page_it->first,pages_[targetR].GetData());
-        pages_[targetR].ResetMemory();
-        pages_[targetR].page_id_ = page_id;
-        pages_[targetR].is_dirty_ = false;
-        pages_[targetR].pin_count_ = 1;
-        page_table_.insert(pair<page_id_t, frame_id_t>(page_id,targetR));
-        if(page_it!=page_table_.end()){
-            page_table_.erase(page_it);
-        }
-        return &pages_[targetR];
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
+    if (free_list_.empty() && replacer_->Size() == 0) {
+      return nullptr;
+    }
+    page_id = AllocatePage(owner_id);
+    // the database file is full
+    if (page_id == INVALID_PAGE_ID) {
+      return nullptr;
     }
+    Page *page = NewPageAt(page_id);
+    // no frame, e.g. the victim could not be written back
+    if (page == nullptr) {
+      DeallocatePage(page_id);
+      page_id = INVALID_PAGE_ID;
+    }
+    return page;
 }
 
 bool BufferPoolManager::DeletePage(page_id_t page_id) {
@@ -121,48 +176,223 @@ bool BufferPoolManager::DeletePage(page_id_t page_id) {
     // 1.   If P does not exist, return true.
     // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
     // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
-    unordered_map<page_id_t, frame_id_t> ::iterator page_it;
-    page_it = page_table_.find(page_id);
-    if(page_it == page_table_.end())
+    std::unique_lock<std::recursive_mutex> lock(latch_);
+    auto page_it = page_table_.find(page_id);
+    // the flusher holds a pin while it writes the page, wait for it rather than report the page as in use
+    while (page_it != page_table_.end() && write_pending_[page_it->second]) {
+      io_cv_.wait(lock);
+      page_it = page_table_.find(page_id);
+    }
+    if (page_it == page_table_.end())
         return true;
-    if(pages_[page_it->second].pin_count_!=0)
+    frame_id_t frame_id = page_it->second;
+    if (pages_[frame_id].pin_count_ != 0)
         return false;
-    pages_[page_it->second].ResetMemory();
-    pages_[page_it->second].pin_count_=0;
-    pages_[page_it->second].page_id_ = INVALID_PAGE_ID;
-    pages_[page_it->second].is_dirty_ = false;
-    disk_manager_->DeAllocatePage(page_id);
-    free_list_.push_front(page_it->second);
+    // the frame is going back to the free list, it must not be handed out by the replacer as well
+    replacer_->Remove(frame_id);
+    pages_[frame_id].ResetMemory();
+    pages_[frame_id].pin_count_ = 0;
+    pages_[frame_id].page_id_ = INVALID_PAGE_ID;
+    pages_[frame_id].is_dirty_ = false;
+    DeallocatePage(page_id);
+    free_list_.push_front(frame_id);
     page_table_.erase(page_it);
     return true;
 }
 
 bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty)
 {
-    unordered_map<page_id_t, frame_id_t> ::iterator page_it;
-    page_it = page_table_.find(page_id);
-    if (page_it == page_table_.end() || page_it->first<0) 
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
+    auto page_it = page_table_.find(page_id);
+    if (page_it == page_table_.end() || page_it->first < 0)
+        return false;
+    Page &page = pages_[page_it->second];
+    if (page.pin_count_ <= 0)
         return false;
-    if(is_dirty)
-        disk_manager_->WritePage(page_it->first,pages_[page_it->second].GetData());
-    pages_[page_it->second].pin_count_ = 0;
-    replacer_->Unpin(page_it->second);
+    // write back is deferred to the flusher or to eviction
+    page.is_dirty_ = page.is_dirty_ || is_dirty;
+    if (is_dirty && write_pending_[page_it->second]) {
+      // the flusher is writing an older image, the page must stay dirty after that
+      dirtied_while_writing_[page_it->second] = true;
+    }
+    if (--page.pin_count_ == 0)
+        replacer_->Unpin(page_it->second);
     return true;
 }
 
 bool BufferPoolManager::FlushPage(page_id_t page_id) {
-    size_t i;
-    for(i = 0;i<pool_size_;i++)
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
+    auto page_it = page_table_.find(page_id);
+    if (page_it == page_table_.end()) {
+      return false;
+    }
+    Page &page = pages_[page_it->second];
+    // nothing to write while a prefetch is reading the page
+    if (io_pending_[page_it->second]) {
+      return true;
+    }
+    if (!disk_manager_->WritePage(page.page_id_, page.GetData())) {
+      return false;
+    }
+    page.is_dirty_ = false;
+    return true;
+}
+
+void BufferPoolManager::FlushAllPages() {
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
+    for (auto &page : page_table_) {
+      FlushPage(page.first);
+    }
+}
+
+size_t BufferPoolManager::FlushDirtyPages(size_t max_pages) {
+    // Pinned pages may be modified concurrently without holding latch_, so only unpinned ones are written.
+    // Their images are copied under the latch, then the latch is released for the I/O. The frames stay pinned until
+    // the copies reached the file, otherwise a page could be evicted as clean and re-read from disk before that.
+    // A page is only marked clean once its write succeeded and nobody dirtied it again meanwhile, a page whose write
+    // failed is retried by the next round.
+    std::vector<frame_id_t> frames;
+    std::vector<char> images;
+    std::vector<std::pair<page_id_t, const char *>> batch;
+    {
+      std::scoped_lock<std::recursive_mutex> lock(latch_);
+      for (size_t i = 0; i < pool_size_ && frames.size() < max_pages; i++) {
+        Page &page = pages_[i];
+        if (page.page_id_ != INVALID_PAGE_ID && page.is_dirty_ && page.pin_count_ == 0) {
+          frames.push_back(i);
+        }
+      }
+      if (frames.empty()) {
+        return 0;
+      }
+      images.resize(frames.size() * PAGE_SIZE);
+      for (size_t i = 0; i < frames.size(); i++) {
+        Page &page = pages_[frames[i]];
+        memcpy(images.data() + i * PAGE_SIZE, page.GetData(), PAGE_SIZE);
+        batch.emplace_back(page.page_id_, images.data() + i * PAGE_SIZE);
+        page.pin_count_ = 1;
+        replacer_->Pin(frames[i]);
+        write_pending_[frames[i]] = true;
+      }
+      flushes_in_flight_++;
+    }
+    // the whole batch is in flight at once
+    std::vector<bool> written = disk_manager_->WritePagesAsync(std::move(batch)).get();
+    size_t num_written = 0;
+    {
+      std::scoped_lock<std::recursive_mutex> lock(latch_);
+      for (size_t i = 0; i < frames.size(); i++) {
+        Page &page = pages_[frames[i]];
+        if (written[i]) {
+          page.is_dirty_ = page.is_dirty_ && dirtied_while_writing_[frames[i]];
+          num_written++;
+        } else {
+          LOG(ERROR) << "Failed to write back page " << page.page_id_ << ", it stays dirty";
+        }
+        write_pending_[frames[i]] = false;
+        dirtied_while_writing_[frames[i]] = false;
+        if (--page.pin_count_ == 0) {
+          replacer_->Unpin(frames[i]);
+        }
+      }
+      flushes_in_flight_--;
+    }
+    io_cv_.notify_all();
+    return num_written;
+}
+
+void BufferPoolManager::FlusherLoop() {
+    std::unique_lock<std::mutex> lock(flusher_mutex_);
+    while (!stop_flusher_) {
+      flusher_cv_.wait_for(lock, std::chrono::milliseconds(DEFAULT_FLUSH_INTERVAL_MS),
+                           [this] { return stop_flusher_.load(); });
+      if (stop_flusher_) {
+        break;
+      }
+      lock.unlock();
+      // keep going while full batches come back, a burst of updates should not wait several periods
+      while (FlushDirtyPages() == static_cast<size_t>(DEFAULT_FLUSH_BATCH_SIZE) && !stop_flusher_) {}
+      lock.lock();
+    }
+}
+
+void BufferPoolManager::PrefetchChain(page_id_t page_id, NextPageIdFn get_next, size_t depth,
+                                      std::shared_ptr<BufferAccessStrategy> strategy) {
+    // chains are followed without latching the pages, a negative id read from a page being modified ends them
+    if (page_id < 0 || depth == 0) {
+      return;
+    }
+    page_id_t next_page_id;
     {
-      if (pages_[i].page_id_ < 0) return false;
-      disk_manager_->WritePage(pages_[i].page_id_, pages_[i].GetData());
+      std::scoped_lock<std::recursive_mutex> lock(latch_);
+      if (stop_prefetch_) {
+        return;
+      }
+      auto page_it = page_table_.find(page_id);
+      if (page_it == page_table_.end()) {
+        frame_id_t frame_id = strategy == nullptr ? GetVictimFrame() : GetStrategyFrame(strategy.get(), page_id);
+        if (frame_id == INVALID_FRAME_ID) {
+          return;
+        }
+        // the prefetch holds a pin until the read completes, so the frame is neither evicted nor flushed meanwhile
+        Page &page = pages_[frame_id];
+        page.page_id_ = page_id;
+        page.is_dirty_ = false;
+        page.pin_count_ = 1;
+        io_pending_[frame_id] = true;
+        page_table_.emplace(page_id, frame_id);
+        prefetches_in_flight_++;
+        disk_manager_->ReadPageAsync(page_id, page.data_, [this, frame_id, get_next, depth, strategy](bool read) {
+          CompletePrefetch(frame_id, read, get_next, depth, strategy);
+        });
+        return;
+      }
+      // an earlier prefetch is still reading this page and will follow the chain itself
+      if (io_pending_[page_it->second]) {
+        return;
+      }
+      next_page_id = get_next(pages_[page_it->second].GetData());
     }
-    if(i == pool_size_) return true;
-    else return false;
+    prefetch_owner_->PrefetchChain(next_page_id, get_next, depth - 1, std::move(strategy));
 }
 
-page_id_t BufferPoolManager::AllocatePage() {
-    int next_page_id = disk_manager_->AllocatePage();
+void BufferPoolManager::CompletePrefetch(frame_id_t frame_id, bool read, NextPageIdFn get_next, size_t depth,
+                                         std::shared_ptr<BufferAccessStrategy> strategy) {
+    page_id_t next_page_id = INVALID_PAGE_ID;
+    {
+      std::scoped_lock<std::recursive_mutex> lock(latch_);
+      Page &page = pages_[frame_id];
+      io_pending_[frame_id] = false;
+      if (!read) {
+        // drop the page, a reader waiting for it reads it itself and sees the error
+        page_table_.erase(page.page_id_);
+        page.page_id_ = INVALID_PAGE_ID;
+        page.pin_count_ = 0;
+        free_list_.push_front(frame_id);
+      } else {
+        next_page_id = get_next(page.GetData());
+        if (--page.pin_count_ == 0) {
+          replacer_->Unpin(frame_id);
+        }
+      }
+    }
+    io_cv_.notify_all();
+    prefetch_owner_->PrefetchChain(next_page_id, get_next, depth - 1, std::move(strategy));
+    {
+      std::scoped_lock<std::recursive_mutex> lock(latch_);
+      prefetches_in_flight_--;
+    }
+    io_cv_.notify_all();
+}
+
+void BufferPoolManager::StopPrefetch() {
+    std::unique_lock<std::recursive_mutex> lock(latch_);
+    stop_prefetch_ = true;
+    io_cv_.wait(lock, [this] { return prefetches_in_flight_ == 0; });
+}
+
+page_id_t BufferPoolManager::AllocatePage(extent_owner_t owner_id) {
+    int next_page_id = disk_manager_->AllocatePage(owner_id);
     return next_page_id;
 }
 
@@ -177,6 +407,9 @@ bool BufferPoolManager::IsPageFree(page_id_t page_id) {
 
 // Only used for debug
 bool BufferPoolManager::CheckAllUnpinned() {
+  std::unique_lock<std::recursive_mutex> lock(latch_);
+  // pins held by prefetches and flushes in flight are not leaks
+  io_cv_.wait(lock, [this] { return prefetches_in_flight_ == 0 && flushes_in_flight_ == 0; });
   bool res = true;
   for (size_t i = 0; i < pool_size_; i++) {
     if (pages_[i].pin_count_ != 0) {
@@ -185,4 +418,4 @@ bool BufferPoolManager::CheckAllUnpinned() {
     }
   }
   return res;
-}
\ No newline at end of file
+}
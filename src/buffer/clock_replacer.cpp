@@ -0,0 +1,52 @@
+#include "buffer/clock_replacer.h"
+
+ClockReplacer::ClockReplacer(size_t num_pages)
+        : num_pages_(num_pages), states_(new std::atomic<uint8_t>[num_pages]) {
+  for (size_t i = 0; i < num_pages_; i++) {
+    states_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+ClockReplacer::~ClockReplacer() = default;
+
+bool ClockReplacer::Victim(frame_id_t *frame_id) {
+  std::scoped_lock<std::mutex> lock(hand_latch_);
+  // At most two full rounds are needed to clear the reference bits and come back to a candidate. Pin/Unpin may
+  // race with the sweep, so keep going as long as the replacer still claims to have candidates.
+  while (size_.load(std::memory_order_acquire) > 0) {
+    auto &state = states_[hand_];
+    frame_id_t candidate = static_cast<frame_id_t>(hand_);
+    hand_ = (hand_ + 1) % num_pages_;
+    uint8_t cur = state.load(std::memory_order_acquire);
+    if (!(cur & IN_REPLACER)) {
+      continue;
+    }
+    if (cur & REFERENCED) {
+      // second chance
+      state.compare_exchange_strong(cur, IN_REPLACER, std::memory_order_acq_rel);
+      continue;
+    }
+    if (state.compare_exchange_strong(cur, 0, std::memory_order_acq_rel)) {
+      size_.fetch_sub(1, std::memory_order_acq_rel);
+      *frame_id = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ClockReplacer::Pin(frame_id_t frame_id) {
+  if (states_[frame_id].exchange(0, std::memory_order_acq_rel) & IN_REPLACER) {
+    size_.fetch_sub(1, std::memory_order_acq_rel);
+  }
+}
+
+void ClockReplacer::Unpin(frame_id_t frame_id) {
+  if (!(states_[frame_id].exchange(IN_REPLACER | REFERENCED, std::memory_order_acq_rel) & IN_REPLACER)) {
+    size_.fetch_add(1, std::memory_order_acq_rel);
+  }
+}
+
+size_t ClockReplacer::Size() {
+  return size_.load(std::memory_order_acquire);
+}
@@ -0,0 +1,69 @@
+#include "buffer/lru_k_replacer.h"
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k)
+        : num_pages_(num_pages), k_(k), history_(num_pages), evictable_(num_pages, false) {
+  ASSERT(k_ > 0, "k of LRU-K must be positive.");
+}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (evict_queue_.empty()) {
+    return false;
+  }
+  auto victim = evict_queue_.begin();
+  *frame_id = std::get<2>(*victim);
+  evict_queue_.erase(victim);
+  evictable_[*frame_id] = false;
+  // the frame is about to hold another page
+  history_[*frame_id].clear();
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (!evictable_[frame_id]) {
+    return;
+  }
+  evict_queue_.erase(GetEvictKey(frame_id));
+  evictable_[frame_id] = false;
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (evictable_[frame_id]) {
+    return;
+  }
+  evict_queue_.insert(GetEvictKey(frame_id));
+  evictable_[frame_id] = true;
+}
+
+void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (evictable_[frame_id]) {
+    evict_queue_.erase(GetEvictKey(frame_id));
+  }
+  auto &history = history_[frame_id];
+  history.push_back(current_timestamp_++);
+  if (history.size() > k_) {
+    history.pop_front();
+  }
+  if (evictable_[frame_id]) {
+    evict_queue_.insert(GetEvictKey(frame_id));
+  }
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (evictable_[frame_id]) {
+    evict_queue_.erase(GetEvictKey(frame_id));
+    evictable_[frame_id] = false;
+  }
+  history_[frame_id].clear();
+}
+
+size_t LRUKReplacer::Size() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return evict_queue_.size();
+}
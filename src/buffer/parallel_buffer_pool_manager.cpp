@@ -0,0 +1,102 @@
+#include "buffer/parallel_buffer_pool_manager.h"
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size,
+                                                     DiskManager *disk_manager, ReplacerType replacer_type)
+        : BufferPoolManager(disk_manager), num_instances_(num_instances), pool_size_per_instance_(pool_size) {
+  ASSERT(num_instances_ > 0, "Parallel buffer pool needs at least one instance.");
+  instances_.reserve(num_instances_);
+  for (size_t i = 0; i < num_instances_; i++) {
+    instances_.push_back(new BufferPoolManager(pool_size_per_instance_, disk_manager, replacer_type));
+    // a chain hops between shards, each step is routed through this manager
+    instances_.back()->prefetch_owner_ = this;
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  // a completing prefetch may continue its chain in any shard, so all of them must be quiet before one is deleted
+  for (auto instance : instances_) {
+    instance->StopPrefetch();
+  }
+  for (auto instance : instances_) {
+    delete instance;
+  }
+}
+
+Page *ParallelBufferPoolManager::FetchPage(page_id_t page_id, BufferAccessStrategy *strategy) {
+  return GetInstance(page_id)->FetchPage(page_id, strategy);
+}
+
+bool ParallelBufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
+  return GetInstance(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+bool ParallelBufferPoolManager::FlushPage(page_id_t page_id) {
+  return GetInstance(page_id)->FlushPage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPages() {
+  for (auto instance : instances_) {
+    instance->FlushAllPages();
+  }
+}
+
+size_t ParallelBufferPoolManager::FlushDirtyPages(size_t max_pages) {
+  size_t flushed = 0;
+  for (auto instance : instances_) {
+    flushed += instance->FlushDirtyPages(max_pages);
+  }
+  return flushed;
+}
+
+void ParallelBufferPoolManager::PrefetchChain(page_id_t page_id, NextPageIdFn get_next, size_t depth,
+                                              std::shared_ptr<BufferAccessStrategy> strategy) {
+  if (page_id >= 0) {
+    GetInstance(page_id)->PrefetchChain(page_id, get_next, depth, std::move(strategy));
+  }
+}
+
+Page *ParallelBufferPoolManager::NewPage(page_id_t &page_id, extent_owner_t owner_id) {
+  // The shard is decided by the page id, so the id has to be allocated before a frame can be picked.
+  // If the owning shard turns out to be fully pinned, hold on to the id and allocate another one, which
+  // usually belongs to the next shard. The held ids are given back once a page is created or every shard was tried.
+  std::vector<page_id_t> skipped;
+  Page *page = nullptr;
+  for (size_t i = 0; i < num_instances_ && page == nullptr; i++) {
+    page_id = disk_manager_->AllocatePage(owner_id);
+    // the database file is full
+    if (page_id == INVALID_PAGE_ID) {
+      break;
+    }
+    BufferPoolManager *instance = GetInstance(page_id);
+    {
+      std::scoped_lock<std::recursive_mutex> lock(instance->latch_);
+      page = instance->NewPageAt(page_id);
+    }
+    if (page == nullptr) {
+      skipped.push_back(page_id);
+    }
+  }
+  for (auto skipped_id : skipped) {
+    disk_manager_->DeAllocatePage(skipped_id);
+  }
+  if (page == nullptr) {
+    page_id = INVALID_PAGE_ID;
+  }
+  return page;
+}
+
+bool ParallelBufferPoolManager::DeletePage(page_id_t page_id) {
+  return GetInstance(page_id)->DeletePage(page_id);
+}
+
+bool ParallelBufferPoolManager::IsPageFree(page_id_t page_id) {
+  return disk_manager_->IsPageFree(page_id);
+}
+
+bool ParallelBufferPoolManager::CheckAllUnpinned() {
+  bool res = true;
+  for (auto instance : instances_) {
+    res = instance->CheckAllUnpinned() && res;
+  }
+  return res;
+}
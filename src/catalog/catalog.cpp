@@ -100,7 +100,7 @@ CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManag
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      heap_(new SimpleMemHeap()) {
+      heap_(new ArenaMemHeap()) {
   // ASSERT(false, "Not Implemented yet");
   if (init == true) {
     /*Page *catalog_page=buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID);
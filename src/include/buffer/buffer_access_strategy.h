@@ -0,0 +1,45 @@
+#ifndef MINISQL_BUFFER_ACCESS_STRATEGY_H
+#define MINISQL_BUFFER_ACCESS_STRATEGY_H
+
+#include <mutex>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+class BufferPoolManager;
+
+/**
+ * BufferAccessStrategy is a small private ring of frames for bulk reads such as sequential scans.
+ *
+ * When a page read through the strategy misses the buffer pool, the frame loaded ring_size reads ago is reused
+ * if nobody else pinned or replaced it meanwhile. A scan therefore cycles through its own handful of frames
+ * instead of pushing the whole working set out of the shared pool.
+ *
+ * A strategy is owned by a single scan. Besides the scan itself, only the prefetches it started use the ring.
+ */
+class BufferAccessStrategy {
+  friend class BufferPoolManager;
+
+public:
+  explicit BufferAccessStrategy(size_t ring_size = DEFAULT_SCAN_RING_SIZE) : ring_(ring_size) {
+    ASSERT(ring_size > 0, "Buffer ring can not be empty.");
+  }
+
+  DISALLOW_COPY(BufferAccessStrategy)
+
+  inline size_t GetRingSize() const { return ring_.size(); }
+
+private:
+  struct RingSlot {
+    BufferPoolManager *owner_{nullptr};     // buffer pool instance the frame belongs to
+    frame_id_t frame_id_{INVALID_FRAME_ID};
+    page_id_t page_id_{INVALID_PAGE_ID};    // page loaded into the frame by this strategy
+  };
+
+  std::vector<RingSlot> ring_;
+  size_t current_{0};
+  std::mutex latch_;                        // prefetches may take frames from the ring on I/O threads
+};
+
+#endif  // MINISQL_BUFFER_ACCESS_STRATEGY_H
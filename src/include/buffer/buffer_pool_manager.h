@@ -1,10 +1,18 @@
 #ifndef MINISQL_BUFFER_POOL_MANAGER_H
 #define MINISQL_BUFFER_POOL_MANAGER_H
 
+#include <atomic>
+#include <condition_variable>
 #include <list>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
 #include "buffer/lru_replacer.h"
 #include "page/page.h"
 #include "page/disk_file_meta_page.h"
@@ -12,46 +20,137 @@
 
 using namespace std;
 
+/** Extracts the id of the next page of a chain from raw page data, INVALID_PAGE_ID ends the chain */
+using NextPageIdFn = page_id_t (*)(const char *page_data);
+
 class BufferPoolManager {
+  friend class ParallelBufferPoolManager;
+
 public:
-  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager);
+  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager,
+                             ReplacerType replacer_type = ReplacerType::kLRU);
+
+  virtual ~BufferPoolManager();
+
+  /**
+   * @param strategy if not null, a miss recycles a frame from the strategy's ring instead of the shared pool
+   */
+  virtual Page *FetchPage(page_id_t page_id, BufferAccessStrategy *strategy = nullptr);
+
+  virtual bool UnpinPage(page_id_t page_id, bool is_dirty);
+
+  /**
+   * @return false if the page is not in the pool or could not be written, it stays dirty then
+   */
+  virtual bool FlushPage(page_id_t page_id);
 
-  ~BufferPoolManager();
+  virtual void FlushAllPages();
 
-  Page *FetchPage(page_id_t page_id);
+  /**
+   * @param owner_id table heap or index the page belongs to, its pages are allocated from contiguous runs
+   */
+  virtual Page *NewPage(page_id_t &page_id, extent_owner_t owner_id = INVALID_EXTENT_OWNER);
 
-  bool UnpinPage(page_id_t page_id, bool is_dirty);
+  virtual bool DeletePage(page_id_t page_id);
 
-  bool FlushPage(page_id_t page_id);
+  virtual bool IsPageFree(page_id_t page_id);
 
-  Page *NewPage(page_id_t &page_id);
+  virtual bool CheckAllUnpinned();
 
-  bool DeletePage(page_id_t page_id);
+  /** @return the total number of frames managed by this buffer pool */
+  virtual size_t GetPoolSize() { return pool_size_; }
+
+  /**
+   * Write back up to max_pages dirty and unpinned pages in one batch, ordered by page id.
+   * Called periodically by the background flusher, so eviction rarely has to write a page itself.
+   * A page whose write fails stays dirty and is picked up again by a later call.
+   * @return number of pages written
+   */
+  virtual size_t FlushDirtyPages(size_t max_pages = DEFAULT_FLUSH_BATCH_SIZE);
+
+  /**
+   * Start loading the pages of a next pointer chain (table pages, B+ tree leaves) in the background, so that a
+   * sequential reader finds them resident when it gets there. Resident pages are followed without I/O.
+   * @param page_id first page of the chain to load
+   * @param get_next extracts the next page id from page data
+   * @param depth number of pages to load ahead
+   * @param strategy if not null, frames for the loaded pages come from the strategy's ring
+   */
+  virtual void PrefetchChain(page_id_t page_id, NextPageIdFn get_next, size_t depth = DEFAULT_PREFETCH_DEPTH,
+                             std::shared_ptr<BufferAccessStrategy> strategy = nullptr);
 
-  bool IsPageFree(page_id_t page_id);
+  /**
+   * Refuse new prefetches and wait for the ones in flight
+   */
+  void StopPrefetch();
 
-  bool CheckAllUnpinned();
+protected:
+  /**
+   * Used by subclasses which do not own any frame themselves
+   */
+  explicit BufferPoolManager(DiskManager *disk_manager);
 
 private:
   /**
    * Allocate new page (operations like create index/table) For now just keep an increasing counter
    */
-  page_id_t AllocatePage();
+  page_id_t AllocatePage(extent_owner_t owner_id);
 
   /**
    * Deallocate page (operations like drop index/table) Need bitmap in header page for tracking pages
    */
   void DeallocatePage(page_id_t page_id);
 
+  /**
+   * Take a frame from the free list, or evict one picked by the replacer. The evicted page is written back
+   * if dirty and removed from the page table. Caller must hold latch_.
+   * @return INVALID_FRAME_ID if every frame is pinned or the dirty victim could not be written
+   */
+  frame_id_t GetVictimFrame();
+
+  /**
+   * Reuse the frame at the current slot of the strategy's ring if it still holds the page the strategy loaded
+   * and is unpinned, otherwise fall back to GetVictimFrame. Caller must hold latch_.
+   */
+  frame_id_t GetStrategyFrame(BufferAccessStrategy *strategy, page_id_t page_id);
+
+  /**
+   * Bind an already allocated page id to a zeroed frame. Caller must hold latch_.
+   */
+  Page *NewPageAt(page_id_t page_id);
+
+  /**
+   * Body of the background flusher thread
+   */
+  void FlusherLoop();
+
+  /**
+   * Called on an I/O thread once a prefetched page is loaded, releases the frame and follows the chain
+   * @param read false if the read failed, the frame is freed and the chain ends
+   */
+  void CompletePrefetch(frame_id_t frame_id, bool read, NextPageIdFn get_next, size_t depth,
+                        std::shared_ptr<BufferAccessStrategy> strategy);
 
 private:
   size_t pool_size_;                                        // number of pages in buffer pool
-  Page *pages_;                                             // array of pages
+  Page *pages_;                                             // array of pages, pages_[i].page_id_ maps frame to page
   DiskManager *disk_manager_;                               // pointer to the disk manager.
   std::unordered_map<page_id_t, frame_id_t> page_table_;    // to keep track of pages
   Replacer *replacer_;                                      // to find an unpinned page for replacement
   std::list<frame_id_t> free_list_;                         // to find a free page for replacement
   recursive_mutex latch_;                                   // to protect shared data structure
+  std::thread flusher_;                                     // background writer of dirty pages
+  std::mutex flusher_mutex_;                                // protects flusher_cv_ waits
+  std::condition_variable flusher_cv_;                      // wakes the flusher up early on shutdown
+  std::atomic<bool> stop_flusher_{false};                   // set on destruction
+  std::vector<bool> io_pending_;                            // frames a prefetch is still reading into
+  std::condition_variable_any io_cv_;                       // signaled when a prefetch or flush completes
+  std::vector<bool> write_pending_;                         // frames the flusher is writing back
+  std::vector<bool> dirtied_while_writing_;                 // frames unpinned dirty while their write was pending
+  size_t prefetches_in_flight_{0};
+  size_t flushes_in_flight_{0};
+  bool stop_prefetch_{false};
+  BufferPoolManager *prefetch_owner_{this};                 // manager a prefetch chain continues in
 };
 
 #endif  // MINISQL_BUFFER_POOL_MANAGER_H
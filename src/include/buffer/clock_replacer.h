@@ -0,0 +1,49 @@
+#ifndef MINISQL_CLOCK_REPLACER_H
+#define MINISQL_CLOCK_REPLACER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+/**
+ * ClockReplacer implements the CLOCK (second chance) replacement policy.
+ *
+ * Every frame owns one atomic state byte holding an "in replacer" bit and a reference bit, so Pin and Unpin
+ * are a single atomic exchange and never take a lock. Only Victim serializes on the clock hand.
+ */
+class ClockReplacer : public Replacer {
+public:
+  /**
+   * Create a new ClockReplacer.
+   * @param num_pages the maximum number of pages the ClockReplacer will be required to store
+   */
+  explicit ClockReplacer(size_t num_pages);
+
+  /**
+   * Destroys the ClockReplacer.
+   */
+  ~ClockReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+private:
+  static constexpr uint8_t IN_REPLACER = 0x1;
+  static constexpr uint8_t REFERENCED = 0x2;
+
+  size_t num_pages_;
+  std::unique_ptr<std::atomic<uint8_t>[]> states_;
+  std::atomic<size_t> size_{0};
+  size_t hand_{0};
+  std::mutex hand_latch_;
+};
+
+#endif  // MINISQL_CLOCK_REPLACER_H
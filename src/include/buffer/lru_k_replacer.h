@@ -0,0 +1,67 @@
+#ifndef MINISQL_LRU_K_REPLACER_H
+#define MINISQL_LRU_K_REPLACER_H
+
+#include <deque>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy.
+ *
+ * The victim is the evictable frame with the largest backward k-distance, i.e. the distance between now and the
+ * k-th most recent access. Frames accessed less than k times have an infinite distance and are evicted first,
+ * oldest first access wins. A single scan touches each page once, so its pages never outlive index pages that
+ * are accessed over and over.
+ */
+class LRUKReplacer : public Replacer {
+public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k number of historical accesses considered for each frame
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = DEFAULT_LRUK_REPLACER_K);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void RecordAccess(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+private:
+  /** (has k accesses, timestamp of the k-th most recent or the first access, frame id) */
+  using EvictKey = std::tuple<bool, uint64_t, frame_id_t>;
+
+  /** Caller must hold latch_ */
+  EvictKey GetEvictKey(frame_id_t frame_id) const {
+    const auto &history = history_[frame_id];
+    return {history.size() >= k_, history.empty() ? 0 : history.front(), frame_id};
+  }
+
+  size_t num_pages_;
+  size_t k_;
+  uint64_t current_timestamp_{0};
+  std::vector<std::deque<uint64_t>> history_;   // last k access timestamps of each frame, oldest first
+  std::vector<bool> evictable_;
+  std::set<EvictKey> evict_queue_;               // evictable frames, victim first
+  std::mutex latch_;
+};
+
+#endif  // MINISQL_LRU_K_REPLACER_H
@@ -0,0 +1,60 @@
+#ifndef MINISQL_PARALLEL_BUFFER_POOL_MANAGER_H
+#define MINISQL_PARALLEL_BUFFER_POOL_MANAGER_H
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+
+/**
+ * ParallelBufferPoolManager shards pages over several independent BufferPoolManager instances.
+ * A page always lives in instance (page_id % num_instances), so each instance only needs its own latch
+ * and accesses to different shards never contend with each other.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+public:
+  /**
+   * @param num_instances number of shards
+   * @param pool_size number of frames in each shard
+   * @param replacer_type replacement policy used by every shard
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            ReplacerType replacer_type = ReplacerType::kLRU);
+
+  ~ParallelBufferPoolManager() override;
+
+  Page *FetchPage(page_id_t page_id, BufferAccessStrategy *strategy = nullptr) override;
+
+  bool UnpinPage(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPage(page_id_t page_id) override;
+
+  void FlushAllPages() override;
+
+  Page *NewPage(page_id_t &page_id, extent_owner_t owner_id = INVALID_EXTENT_OWNER) override;
+
+  bool DeletePage(page_id_t page_id) override;
+
+  bool IsPageFree(page_id_t page_id) override;
+
+  bool CheckAllUnpinned() override;
+
+  size_t GetPoolSize() override { return num_instances_ * pool_size_per_instance_; }
+
+  size_t FlushDirtyPages(size_t max_pages = DEFAULT_FLUSH_BATCH_SIZE) override;
+
+  void PrefetchChain(page_id_t page_id, NextPageIdFn get_next, size_t depth = DEFAULT_PREFETCH_DEPTH,
+                     std::shared_ptr<BufferAccessStrategy> strategy = nullptr) override;
+
+private:
+  /** @return the shard responsible for page_id */
+  BufferPoolManager *GetInstance(page_id_t page_id) {
+    return instances_[static_cast<uint32_t>(page_id) % num_instances_];
+  }
+
+private:
+  size_t num_instances_;
+  size_t pool_size_per_instance_;
+  std::vector<BufferPoolManager *> instances_;
+};
+
+#endif  // MINISQL_PARALLEL_BUFFER_POOL_MANAGER_H
@@ -4,6 +4,13 @@
 #include <cstdio>
 #include "common/config.h"
 
+/**
+ * Replacement policies a BufferPoolManager can be constructed with.
+ */
+enum class ReplacerType {
+  kLRU = 0, kClock, kLRUK
+};
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -32,6 +39,18 @@ public:
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Records that the page held by a frame has been accessed. Policies that only look at unpin order can ignore it.
+   * @param frame_id the id of the frame that was accessed
+   */
+  virtual void RecordAccess(frame_id_t frame_id) {}
+
+  /**
+   * Forgets a frame whose page has been deleted, it will not be victimized until it is unpinned again.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
 };
@@ -94,7 +94,7 @@ class IndexInfo {
 
  private:
   explicit IndexInfo()
-      : meta_data_{nullptr}, index_{nullptr}, table_info_{nullptr}, key_schema_{nullptr}, heap_(new SimpleMemHeap()) {}
+      : meta_data_{nullptr}, index_{nullptr}, table_info_{nullptr}, key_schema_{nullptr}, heap_(new ArenaMemHeap()) {}
 
  private:
   IndexMetadata *meta_data_;
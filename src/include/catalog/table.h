@@ -72,10 +72,13 @@ public:
 
   inline Schema *GetSchema() const { return table_meta_->schema_; }
 
+  /** @return codec of the rows of this table, built once with its schema */
+  inline const RowCodec &GetRowCodec() const { return table_meta_->schema_->GetRowCodec(); }
+
   inline page_id_t GetRootPageId() const { return table_meta_->root_page_id_; }
 
 private:
-  explicit TableInfo() : heap_(new SimpleMemHeap()) {};
+  explicit TableInfo() : heap_(new ArenaMemHeap()) {};
 
 private:
   TableMetadata *table_meta_;
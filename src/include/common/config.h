@@ -14,7 +14,19 @@ static constexpr int CATALOG_META_PAGE_ID = 0;       // logical page id of the c
 static constexpr int INDEX_ROOTS_PAGE_ID = 1;        // logical page id of the index roots
 
 static constexpr int PAGE_SIZE = 4096;               // size of a data page in byte
+static constexpr int DIRECT_IO_ALIGNMENT = PAGE_SIZE;// buffer alignment for O_DIRECT, covers 4K sector devices
 static constexpr int DEFAULT_BUFFER_POOL_SIZE = 1024;// default size of buffer pool
+static constexpr int DEFAULT_BUFFER_POOL_INSTANCES = 1;// default number of buffer pool shards
+static constexpr int DEFAULT_LRUK_REPLACER_K = 2;    // default k of the LRU-K replacement policy
+static constexpr int DEFAULT_SCAN_RING_SIZE = 32;    // frames recycled by one sequential scan
+static constexpr int DEFAULT_FLUSH_INTERVAL_MS = 50; // period of the background dirty page flusher
+static constexpr int DEFAULT_FLUSH_BATCH_SIZE = 64;  // max pages written back by one flusher round
+static constexpr int DEFAULT_ASYNC_IO_THREADS = 16;  // max number of asynchronous page I/Os in flight
+static constexpr int DEFAULT_PREFETCH_DEPTH = 8;     // pages read ahead of a sequential page chain reader
+static constexpr int DEFAULT_BATCH_SIZE = 1024;      // max tuples of a column batch
+static constexpr int DEFAULT_MORSEL_SIZE = 16;       // pages handed to a parallel scan worker at a time
+static constexpr int DEFAULT_ARENA_CHUNK_SIZE = 4096;// bytes of a memory arena chunk
+static constexpr int ROW_ARENA_CHUNK_SIZE = 256;     // bytes of the first arena chunk of a row
 
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
 static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;    // max length of varchar
@@ -6,6 +6,7 @@
 #include "common/dberr.h"
 #include "common/instance.h"
 #include "transaction/transaction.h"
+#include "utils/mem_heap.h"
 
 extern "C" {
 #include "parser/parser.h"
@@ -20,6 +21,7 @@ extern "C" {
 struct ExecuteContext {
   bool flag_quit_{false};
   Transaction *txn_{nullptr};
+  ArenaMemHeap heap_;  /** memory of the statement, released in one go with the context */
 };
 
 /**
@@ -40,6 +40,11 @@ public:
   // helper methods
   page_id_t GetNextPageId() const;
 
+  /** Next page id read from raw page data, used to follow the chain without a pinned page */
+  static page_id_t GetNextPageId(const char *page_data) {
+    return reinterpret_cast<const BPlusTreeLeafPage *>(page_data)->next_page_id_;
+  }
+
   void SetNextPageId(page_id_t next_page_id);
 
   KeyType KeyAt(int index) const;
@@ -23,12 +23,38 @@ class BitmapPage {
    */
   static constexpr size_t GetMaxSupportedSize() { return 8 * MAX_CHARS; }
 
+  /** Size of the runs found by FindFreeRun, one word of the bitmap */
+  static constexpr uint32_t RUN_SIZE = 64;
+
   /**
+   * Allocate the lowest free page. The search starts at next_free_page_, which no free page precedes, and checks
+   * 64 pages at a time.
    * @param page_offset Index in extent of the page allocated.
    * @return true if successfully allocate a page.
    */
   bool AllocatePage(uint32_t &page_offset);
 
+  /**
+   * Allocate a page known to be free, e.g. found by FindFreePage.
+   * @return false if the page is already allocated.
+   */
+  bool MarkAllocated(uint32_t page_offset);
+
+  /**
+   * @param from first page to consider
+   * @param page_offset the lowest free page not before from
+   * @return false if there is none
+   */
+  bool FindFreePage(uint32_t from, uint32_t &page_offset) const;
+
+  /**
+   * Find a run of RUN_SIZE free pages, runs are aligned to RUN_SIZE.
+   * @param from first page to consider, must be aligned
+   * @param page_offset first page of the lowest free run not before from
+   * @return false if there is none
+   */
+  bool FindFreeRun(uint32_t from, uint32_t &page_offset) const;
+
   /**
    * @return true if successfully de-allocate a page.
    */
@@ -49,8 +75,15 @@ class BitmapPage {
    */
   bool IsPageFreeLow(uint32_t byte_index, uint8_t bit_index) const;
 
+  /**
+   * @return the 64 bits starting at bytes[word_index * 8], the first page of the word in the most significant bit
+   */
+  uint64_t LoadWord(size_t word_index) const;
+
   /** Note: need to update if modify page structure. */
   static constexpr size_t MAX_CHARS = PageSize - 2 * sizeof(uint32_t);
+  static constexpr size_t MAX_WORDS = MAX_CHARS / sizeof(uint64_t);
+  static_assert(MAX_CHARS % sizeof(uint64_t) == 0, "bitmap is searched one 64-bit word at a time");
 
  private:
   /** The space occupied by all members of the class should be equal to the PageSize */
@@ -5,8 +5,23 @@
 
 #include "page/bitmap_page.h"
 
-static constexpr page_id_t MAX_VALID_PAGE_ID = (PAGE_SIZE - 8) / 4 * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+/** Owner of an extent reservation, a table heap or an index */
+using extent_owner_t = uint32_t;
+static constexpr extent_owner_t INVALID_EXTENT_OWNER = 0;
 
+/**
+ * A run of BitmapPage::RUN_SIZE contiguous pages set aside for one owner. Other allocations skip the free pages of
+ * the run, so the pages of a table heap or an index end up physically next to each other.
+ */
+struct ExtentReservation {
+  extent_owner_t owner_id_;
+  page_id_t first_page_id_;
+};
+
+/**
+ * Meta page of one segment file of the database. Besides the counters of the segment's own extents, the meta page
+ * of segment 0 is the root of the database: it holds the extent reservations and the number of segments.
+ */
 class DiskFileMetaPage {
  public:
   uint32_t GetExtentNums() { return num_extents_; }
@@ -19,11 +34,42 @@ class DiskFileMetaPage {
     }
     return extent_used_page_[extent_id];
   }
+
+  /**
+   * Reservations are direct mapped by owner, a new owner may take over the slot of another one whose run then
+   * becomes available to everybody.
+   * @return the reservation slot of an owner
+   */
+  ExtentReservation &GetReservationSlot(extent_owner_t owner_id) {
+    return reservations_[owner_id % MAX_RESERVATIONS];
+  }
+
+  static extent_owner_t TableHeapOwner(page_id_t first_page_id) { return 2 * first_page_id + 1; }
+
+  static extent_owner_t IndexOwner(index_id_t index_id) { return 2 * index_id + 2; }
+
+  static constexpr uint32_t MAX_RESERVATIONS = 64;
+  static constexpr uint32_t MAX_EXTENTS = 512;  // extents per segment
+  // a page id must fit in page_id_t, which caps the database at MAX_SEGMENTS segments
+  static constexpr uint32_t MAX_SEGMENTS = 128;
+  // Version of the on-disk format: segments, table page header with free space map page id and free slot list, rows
+  // with a null bitmap. Bump it on every incompatible change of a page layout, files of another version are rejected.
+  static constexpr uint32_t FORMAT_VERSION = 1;
+
  public:
   uint32_t num_allocated_pages_{0};
   uint32_t num_extents_{0};  // each extent consists with a bit map and BIT_MAP_SIZE pages
-  uint32_t extent_used_page_[0];
+  uint32_t extent_used_page_[MAX_EXTENTS];
+  ExtentReservation reservations_[MAX_RESERVATIONS];
+  uint32_t num_segments_{0};  // only used in segment 0
+  uint32_t format_version_{0};  // only used in segment 0, 0 in files written before it existed
 };
 
-#endif  // MINISQL_DISK_FILE_META_PAGE_H
+static_assert(sizeof(DiskFileMetaPage) <= PAGE_SIZE, "meta page must fit in one page");
 
+static constexpr page_id_t MAX_VALID_PAGE_ID = DiskFileMetaPage::MAX_SEGMENTS * DiskFileMetaPage::MAX_EXTENTS
+                                               * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+static_assert(static_cast<uint64_t>(DiskFileMetaPage::MAX_SEGMENTS) * DiskFileMetaPage::MAX_EXTENTS
+              * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize() <= INT32_MAX, "page ids must fit in page_id_t");
+
+#endif  // MINISQL_DISK_FILE_META_PAGE_H
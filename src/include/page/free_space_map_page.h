@@ -0,0 +1,100 @@
+#ifndef MINISQL_FREE_SPACE_MAP_PAGE_H
+#define MINISQL_FREE_SPACE_MAP_PAGE_H
+
+#include <algorithm>
+#include <cstdint>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+/**
+ * Free space map of a table heap, a two level tree of these pages. The entries of the root are the leaves, the
+ * entries of a leaf are heap pages. Every entry keeps a free space bucket, the free bytes of a heap page rounded
+ * down to a multiple of BUCKET_SIZE, or the largest bucket of a leaf. An insert finds a heap page with enough
+ * room by looking at the root, one leaf and the page itself.
+ *
+ * Buckets may be stale, a page never has less free space than its bucket says unless it was updated in place,
+ * which the insert notices and corrects.
+ * Latches are taken root, leaf, table page in this order. The one exception is a new table page, which is latched
+ * before it is added to the map, nobody else can be waiting for it. Writers latch the root only briefly: shared to
+ * pick a leaf, exclusive to append an entry or to copy the largest bucket of a leaf into its root entry. The
+ * entries of a leaf are protected by the leaf latch.
+ *
+ * Format (size in byte):
+ *  ---------------------------------------------------------------------------------------
+ * | PageId (4) | RootPageId (4) | LastPageId (4) | EntryCount (4) | PageId_1 (4) | ... |
+ *  ---------------------------------------------------------------------------------------
+ *  ----------------------------------
+ * | Bucket_1 (1) | Bucket_2 (1) | ... |
+ *  ----------------------------------
+ * LastPageId is the tail of the heap's page chain, only kept by the root.
+ */
+class FreeSpaceMapPage {
+public:
+  void Init(page_id_t page_id, page_id_t root_page_id) {
+    page_id_ = page_id;
+    root_page_id_ = root_page_id;
+    last_page_id_ = INVALID_PAGE_ID;
+    count_ = 0;
+  }
+
+  page_id_t GetPageId() const { return page_id_; }
+
+  page_id_t GetRootPageId() const { return root_page_id_; }
+
+  page_id_t GetLastPageId() const { return last_page_id_; }
+
+  void SetLastPageId(page_id_t last_page_id) { last_page_id_ = last_page_id; }
+
+  uint32_t GetCount() const { return count_; }
+
+  bool IsFull() const { return count_ == MAX_ENTRIES; }
+
+  page_id_t GetEntryPageId(uint32_t slot) const { return page_ids_[slot]; }
+
+  uint8_t GetBucket(uint32_t slot) const { return buckets_[slot]; }
+
+  void SetBucket(uint32_t slot, uint8_t bucket) { buckets_[slot] = bucket; }
+
+  void Append(page_id_t page_id, uint8_t bucket);
+
+  /**
+   * @return the first slot with a bucket of at least bucket, -1 if there is none
+   */
+  int FindSlot(uint8_t bucket) const;
+
+  /**
+   * @return the slot of page_id, -1 if it is not in this page
+   */
+  int FindPage(page_id_t page_id) const;
+
+  /**
+   * @return the largest bucket of all entries, the bucket of this page in the root
+   */
+  uint8_t GetMaxBucket() const;
+
+  /** @return bucket of a page with free_space free bytes */
+  static uint8_t ToBucket(uint32_t free_space) {
+    return static_cast<uint8_t>(std::min<uint32_t>(free_space / BUCKET_SIZE, UINT8_MAX));
+  }
+
+  /** @return smallest bucket of a page guaranteed to have size free bytes */
+  static uint8_t ToRequiredBucket(uint32_t size) {
+    return static_cast<uint8_t>(std::min<uint32_t>((size + BUCKET_SIZE - 1) / BUCKET_SIZE, UINT8_MAX));
+  }
+
+  static constexpr uint32_t BUCKET_SIZE = PAGE_SIZE / 256;
+  static constexpr uint32_t MAX_ENTRIES = (PAGE_SIZE - 4 * sizeof(uint32_t)) / (sizeof(page_id_t) + sizeof(uint8_t));
+
+private:
+  page_id_t page_id_;
+  page_id_t root_page_id_;
+  page_id_t last_page_id_;
+  uint32_t count_;
+  page_id_t page_ids_[MAX_ENTRIES];
+  uint8_t buckets_[MAX_ENTRIES];
+};
+
+static_assert(sizeof(FreeSpaceMapPage) <= PAGE_SIZE, "free space map page must fit in one page");
+
+#endif  // MINISQL_FREE_SPACE_MAP_PAGE_H
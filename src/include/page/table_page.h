@@ -12,16 +12,26 @@
  *  ----------------------------------------------------------------------------
  *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| FreeSpacePointer(4) |
  *  ----------------------------------------------------------------------------
- *  ----------------------------------------------------------------
- *  | TupleCount (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
- *  ----------------------------------------------------------------
+ *  ------------------------------------------------------------------------------------------
+ *  | TupleCount (4) | FreeSpaceMapPageId (4) | FreeSlotHead (4) | HoleSize (4) | Tuple_1 offset (4) | ... |
+ *  ------------------------------------------------------------------------------------------
+ *  ----------------------------------
+ *  | Tuple_1 size (4) | ... |
+ *  ----------------------------------
+ *  FreeSpaceMapPageId is the free space map leaf holding the page's entry, see FreeSpaceMapPage.
+ *
+ *  Deleting a tuple does not move the others, its bytes become a hole and its slot goes to the head of a list of
+ *  free slots, linked through their offset fields. Inserts take the head of the list in O(1). When the free space
+ *  is too small for an insert or an update but the holes together are large enough, the page is compacted once.
  **/
 
 #include <cstring>
 #include "common/macros.h"
 #include "common/rowid.h"
 #include "page/page.h"
+#include "record/column_batch.h"
 #include "record/row.h"
+#include "record/row_view.h"
 #include "transaction/lock_manager.h"
 #include "transaction/log_manager.h"
 #include "transaction/transaction.h"
@@ -36,6 +46,11 @@ public:
 
   page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
 
+  /** Next page id read from raw page data, used to follow the chain without a pinned page */
+  static page_id_t GetNextPageId(const char *page_data) {
+    return *reinterpret_cast<const page_id_t *>(page_data + OFFSET_NEXT_PAGE_ID);
+  }
+
   void SetPrevPageId(page_id_t prev_page_id) {
     memcpy(GetData() + OFFSET_PREV_PAGE_ID, &prev_page_id, sizeof(page_id_t));
   }
@@ -44,6 +59,12 @@ public:
     memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
   }
 
+  page_id_t GetFreeSpaceMapPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_FSM_PAGE_ID); }
+
+  void SetFreeSpaceMapPageId(page_id_t fsm_page_id) {
+    memcpy(GetData() + OFFSET_FSM_PAGE_ID, &fsm_page_id, sizeof(page_id_t));
+  }
+
   bool InsertTuple(Row &row, Schema *schema, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
 
   bool MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
@@ -57,15 +78,26 @@ public:
 
   bool GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager *lock_manager);
 
+  /**
+   * Reference a tuple in place instead of copying it out
+   * @param[out] view valid as long as the page stays pinned and latched
+   */
+  bool GetTupleView(const RowId &rid, Schema *schema, RowView *view);
+
+  /**
+   * Decode the tuples from slot from_slot on into batch, until the page is done or the batch is full
+   * @return the slot to continue from, GetTupleCount() once the page is done
+   */
+  uint32_t DecodeTuples(uint32_t from_slot, ColumnBatch *batch);
+
   bool GetFirstTupleRid(RowId *first_rid);
 
   bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
 
   //
 
-  uint32_t GetFreeSpaceRemaining() {
-    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
-  }
+  /** @return bytes available to new tuples, including the holes left by deleted tuples */
+  uint32_t GetFreeSpaceRemaining() { return GetContiguousFreeSpace() + GetHoleSize(); }
 
   uint32_t GetTupleSize(uint32_t slot_num) {
     return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num);
@@ -77,6 +109,28 @@ public:
   
 
 private:
+  uint32_t GetContiguousFreeSpace() {
+    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
+  }
+
+  uint32_t GetFreeSlotHead() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SLOT_HEAD); }
+
+  void SetFreeSlotHead(uint32_t slot_num) { memcpy(GetData() + OFFSET_FREE_SLOT_HEAD, &slot_num, sizeof(uint32_t)); }
+
+  uint32_t GetHoleSize() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_HOLE_SIZE); }
+
+  void SetHoleSize(uint32_t hole_size) { memcpy(GetData() + OFFSET_HOLE_SIZE, &hole_size, sizeof(uint32_t)); }
+
+  /**
+   * Give the space of a tuple back, the slot is not touched
+   */
+  void ReleaseTupleSpace(uint32_t tuple_offset, uint32_t tuple_size);
+
+  /**
+   * Pack all tuples against the end of the page in one pass, turning the holes into contiguous free space
+   */
+  void Compact();
+
   uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
 
   void SetFreeSpacePointer(uint32_t free_space_pointer) {
@@ -118,16 +172,20 @@ private:
 private:
   static_assert(sizeof(page_id_t) == 4);
   static constexpr uint64_t DELETE_MASK = (1U << (8 * sizeof(uint32_t) - 1));
-  static constexpr size_t SIZE_TABLE_PAGE_HEADER = 24;
-  static constexpr size_t SIZE_TUPLE = 8;
+  static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+  static constexpr size_t SIZE_TABLE_PAGE_HEADER = 36;
   static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
   static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
   static constexpr size_t OFFSET_FREE_SPACE = 16;
   static constexpr size_t OFFSET_TUPLE_COUNT = 20;
-  static constexpr size_t OFFSET_TUPLE_OFFSET = 24;
-  static constexpr size_t OFFSET_TUPLE_SIZE = 28;
+  static constexpr size_t OFFSET_FSM_PAGE_ID = 24;
+  static constexpr size_t OFFSET_FREE_SLOT_HEAD = 28;
+  static constexpr size_t OFFSET_HOLE_SIZE = 32;
+  static constexpr size_t OFFSET_TUPLE_OFFSET = 36;
+  static constexpr size_t OFFSET_TUPLE_SIZE = 40;
 
 public:
+  static constexpr size_t SIZE_TUPLE = 8;  // slot of a tuple
   static constexpr size_t SIZE_MAX_ROW = PAGE_SIZE - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE;
 };
 
@@ -0,0 +1,138 @@
+#ifndef MINISQL_COLUMN_BATCH_H
+#define MINISQL_COLUMN_BATCH_H
+
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "common/rowid.h"
+#include "record/filter_kernels.h"
+#include "record/schema.h"
+#include "record/type_id.h"
+
+/**
+ * Values of one column of a ColumnBatch. INT and FLOAT values are stored in a plain array, CHAR values are
+ * concatenated in a byte array, value i spans [offsets[i], offsets[i + 1]). A null value is stored as zero or as
+ * an empty string and flagged in the null array.
+ */
+class ColumnVector {
+  friend class ColumnBatch;
+
+public:
+  explicit ColumnVector(TypeId type_id, uint32_t capacity);
+
+  inline TypeId GetType() const { return type_id_; }
+
+  inline bool IsNull(uint32_t i) const { return nulls_[i]; }
+
+  inline const uint8_t *GetNulls() const { return nulls_.data(); }
+
+  inline const int32_t *GetInts() const { return ints_.data(); }
+
+  inline const float *GetFloats() const { return floats_.data(); }
+
+  inline const uint32_t *GetOffsets() const { return offsets_.data(); }
+
+  inline const char *GetBytes() const { return bytes_.data(); }
+
+  /**
+   * @param[out] len length of value i
+   * @return value i, not null terminated
+   */
+  inline const char *GetChars(uint32_t i, uint32_t *len) const {
+    *len = offsets_[i + 1] - offsets_[i];
+    return bytes_.data() + offsets_[i];
+  }
+
+  /**
+   * Write the prefixes of the first count CHAR values, FilterKernels::PREFIX_SIZE bytes each padded with zeros
+   */
+  void CopyPrefixes(uint32_t count, char *prefixes) const;
+
+private:
+  TypeId type_id_;
+  std::vector<int32_t> ints_;
+  std::vector<float> floats_;
+  std::vector<uint32_t> offsets_;
+  std::vector<char> bytes_;
+  std::vector<uint8_t> nulls_;
+};
+
+/**
+ * Up to a fixed number of tuples stored column by column, filled by TableHeap::ScanBatch.
+ * The selection vector lists the positions of the tuples still qualifying, filters shrink it instead of moving
+ * the column values. Filter evaluates a predicate over the whole column with FilterKernels and keeps the selected
+ * tuples whose bit is set, a null value never qualifies.
+ */
+class ColumnBatch {
+public:
+  explicit ColumnBatch(Schema *schema, uint32_t capacity = DEFAULT_BATCH_SIZE);
+
+  inline uint32_t GetSize() const { return size_; }
+
+  inline uint32_t GetCapacity() const { return capacity_; }
+
+  inline bool IsFull() const { return size_ == capacity_; }
+
+  inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
+
+  inline const ColumnVector &GetColumn(uint32_t idx) const { return columns_[idx]; }
+
+  inline RowId GetRowId(uint32_t i) const { return row_ids_[i]; }
+
+  /** @return positions of the selected tuples, GetSelectedCount() of them are valid */
+  inline uint32_t *GetSelection() { return selection_.data(); }
+
+  inline uint32_t GetSelectedCount() const { return selected_count_; }
+
+  inline void SetSelectedCount(uint32_t selected_count) {
+    ASSERT(selected_count <= size_, "Selection larger than the batch.");
+    selected_count_ = selected_count;
+  }
+
+  void Filter(uint32_t idx, CompareOp op, int32_t constant);
+
+  void Filter(uint32_t idx, CompareOp op, float constant);
+
+  void Filter(uint32_t idx, CompareOp op, const char *chars, uint32_t len);
+
+  /**
+   * Keep the selected tuples where column left op column right holds, both columns have the same type
+   */
+  void FilterColumns(uint32_t left, CompareOp op, uint32_t right);
+
+  /**
+   * Decode a serialized row (see Row for the format) into the next position of the batch and select it
+   */
+  void Append(const char *tuple, RowId rid);
+
+  /**
+   * Empty the batch, keeping the memory of its columns
+   */
+  void Reset();
+
+private:
+  /**
+   * Shrink the selection to the tuples with a bit set in bitmap_ and no null value in left or right.
+   * CHAR values with a bit set in ties_ only have equal prefixes and are compared in full.
+   */
+  void Select(const ColumnVector &left, const ColumnVector *right, CompareOp op, const char *chars, uint32_t len,
+              bool check_ties);
+
+  void ReserveFilterBuffers(bool prefixes);
+
+private:
+  Schema *schema_;
+  uint32_t capacity_;
+  uint32_t size_{0};
+  uint32_t selected_count_{0};
+  std::vector<ColumnVector> columns_;
+  std::vector<RowId> row_ids_;
+  std::vector<uint32_t> selection_;
+  std::vector<uint64_t> bitmap_;        /** result of the last filter kernel */
+  std::vector<uint64_t> ties_;          /** CHAR values whose prefixes are equal */
+  std::vector<char> prefixes_;
+  std::vector<char> right_prefixes_;
+};
+
+#endif  // MINISQL_COLUMN_BATCH_H
@@ -17,6 +17,8 @@ class Field {
 
   friend class TypeFloat;
 
+  friend class RowCodec;
+
 public:
   explicit Field(const TypeId type) : type_id_(type), len_(FIELD_NULL_LEN), is_null_(true) {}
 
@@ -49,7 +51,12 @@ public:
       value_.chars_ = nullptr;
       manage_data_ = false;
     } else {
-      if (manage_data) {
+      if (manage_data && len <= INLINE_CHARS_SIZE) {
+        // short strings are kept in the field itself
+        memcpy(value_.inline_chars_, data, len);
+        is_inline_ = true;
+        manage_data_ = false;
+      } else if (manage_data) {
         ASSERT(len < VARCHAR_MAX_LEN, "Field length exceeds max varchar length");
         value_.chars_ = new char[len];
         memcpy(value_.chars_, data, len);
@@ -66,6 +73,7 @@ public:
     len_ = other.len_;
     is_null_ = other.is_null_;
     manage_data_ = other.manage_data_;
+    is_inline_ = other.is_inline_;
     if (type_id_ == TypeId::kTypeChar && !is_null_ && manage_data_) {
       value_.chars_ = new char[len_];
       memcpy(value_.chars_, other.value_.chars_, len_);
@@ -74,12 +82,26 @@ public:
     }
   }
 
+  // move, other keeps pointing at the chars but no longer frees them
+  Field(Field &&other) noexcept
+      : value_(other.value_), type_id_(other.type_id_), len_(other.len_), is_null_(other.is_null_),
+        manage_data_(other.manage_data_), is_inline_(other.is_inline_) {
+    other.manage_data_ = false;
+  }
+
   // copy
   Field &operator=(Field &other) { 
     Swap(*this, other);
     return *this;
   }
 
+  Field &operator=(Field &&other) noexcept {
+    Swap(*this, other);
+    return *this;
+  }
+
+  inline TypeId GetTypeId() const { return type_id_; }
+
   inline bool IsNull() const {
     return is_null_;
   }
@@ -138,18 +160,27 @@ public:
     std::swap(first.len_, second.len_);
     std::swap(first.is_null_, second.is_null_);
     std::swap(first.manage_data_, second.manage_data_);
+    std::swap(first.is_inline_, second.is_inline_);
   }
 
+  /** CHAR values up to this length are stored inline instead of in an allocated copy */
+  static constexpr uint32_t INLINE_CHARS_SIZE = 16;
+
+protected:
+  inline const char *GetChars() const { return is_inline_ ? value_.inline_chars_ : value_.chars_; }
+
 protected:
   union Val {
     int32_t integer_;
     float float_;
     char *chars_;
+    char inline_chars_[INLINE_CHARS_SIZE];
   } value_;
   TypeId type_id_;
   uint32_t len_;
   bool is_null_{false};
   bool manage_data_{false};
+  bool is_inline_{false};
 };
 
 
@@ -0,0 +1,46 @@
+#ifndef MINISQL_FILTER_KERNELS_H
+#define MINISQL_FILTER_KERNELS_H
+
+#include <cstdint>
+
+enum class CompareOp { kEqual, kNotEqual, kLessThan, kLessThanEquals, kGreaterThan, kGreaterThanEquals };
+
+/**
+ * Comparisons of whole column arrays, `col op constant` or `col op col`, without going through Field and Type.
+ * INT and FLOAT kernels use AVX2 or SSE4.2 when the build targets them (the build uses -march=native), CHAR
+ * kernels the SSE4.2 string compare. Without them, the kernels fall back to scalar loops.
+ *
+ * The result is a selection bitmap, bit i % 64 of word i / 64 is set if value i qualifies. A bitmap has
+ * GetBitmapSize(count) words, the bits past count are zero.
+ *
+ * CHAR values are compared by their prefixes, PREFIX_SIZE bytes padded with zeros (see ColumnVector::CopyPrefixes),
+ * in the byte order of memcmp. If two prefixes differ, they order the values like the full strings do. Values with
+ * equal prefixes have to be compared in full unless both are shorter than PREFIX_SIZE and have no zero bytes.
+ */
+class FilterKernels {
+public:
+  static constexpr uint32_t PREFIX_SIZE = 16;
+
+  static inline uint32_t GetBitmapSize(uint32_t count) { return (count + 63) / 64; }
+
+  static inline bool IsSet(const uint64_t *bitmap, uint32_t i) { return (bitmap[i >> 6] >> (i & 63)) & 1; }
+
+  static void Compare(const int32_t *values, uint32_t count, CompareOp op, int32_t constant, uint64_t *bitmap);
+
+  static void Compare(const int32_t *left, const int32_t *right, uint32_t count, CompareOp op, uint64_t *bitmap);
+
+  static void Compare(const float *values, uint32_t count, CompareOp op, float constant, uint64_t *bitmap);
+
+  static void Compare(const float *left, const float *right, uint32_t count, CompareOp op, uint64_t *bitmap);
+
+  /**
+   * @param prefixes count prefixes of PREFIX_SIZE bytes
+   * @param constant prefix of the constant, PREFIX_SIZE bytes
+   */
+  static void ComparePrefixes(const char *prefixes, uint32_t count, CompareOp op, const char *constant,
+                              uint64_t *bitmap);
+
+  static void ComparePrefixes(const char *left, const char *right, uint32_t count, CompareOp op, uint64_t *bitmap);
+};
+
+#endif  // MINISQL_FILTER_KERNELS_H
@@ -2,6 +2,7 @@
 #define MINISQL_ROW_H
 
 #include <memory>
+#include <utility>
 #include <vector>
 #include "common/macros.h"
 #include "common/rowid.h"
@@ -11,23 +12,28 @@
 
 /**
  *  Row format:
- * -------------------------------------------
- * | Header | Field-1 | ... | Field-N |
- * -------------------------------------------
- *  Header format:
- * --------------------------------------------
- * | Field Nums | Null bitmap |
- * -------------------------------------------
- *  
+ * ------------------------------------------------------------------------
+ * | Null bitmap | Fixed size values | Var offset table | Var length data |
+ * ------------------------------------------------------------------------
+ *  Null bitmap: bit i is set if column i is null, (column count + 7) / 8 bytes
+ *  Fixed size values: INT and FLOAT values in column order, zero if null
+ *  Var offset table: for every CHAR value in column order, the offset in the row where it ends (4 bytes)
+ *  Var length data: the CHAR values, a value starts where the previous one ends, empty if null
  *
+ *  The offset of a fixed size value and of the offset table entry of a CHAR value only depend on the schema, see
+ *  RowCodec::GetFieldOffset, so any column is read without decoding the ones before it.
  */
 class Row {
+  friend class RowCodec;
+
 public:
   /**
    * Row used for insert
    * Field integrity should check by upper level
+   * @param heap memory of the fields, e.g. the arena of a statement, if null the row allocates from an arena it owns
    */
-  explicit Row(std::vector<Field> &fields) : heap_(new SimpleMemHeap) {
+  explicit Row(std::vector<Field> &fields, MemHeap *heap = nullptr)
+      : heap_(heap == nullptr ? new ArenaMemHeap(ROW_ARENA_CHUNK_SIZE) : heap), owns_heap_(heap == nullptr) {
     // deep copy
     for (auto &field : fields) {
       void *buf = heap_->Allocate(sizeof(Field));
@@ -43,12 +49,15 @@ public:
   /**
    * Row used for deserialize and update
    */
-  Row(RowId rid) : rid_(rid), heap_(new SimpleMemHeap) {}
+  Row(RowId rid, MemHeap *heap = nullptr)
+      : rid_(rid),
+        heap_(heap == nullptr ? new ArenaMemHeap(ROW_ARENA_CHUNK_SIZE) : heap),
+        owns_heap_(heap == nullptr) {}
 
   /**
    * Row copy function
    */
-  Row(const Row &other) : heap_(new SimpleMemHeap) {
+  Row(const Row &other) : heap_(new ArenaMemHeap(ROW_ARENA_CHUNK_SIZE)) {
     if (!fields_.empty()) {
       for (auto &field : fields_) {
         heap_->Free(field);
@@ -58,12 +67,42 @@ public:
     rid_ = other.rid_;
     for (auto &field : other.fields_) {
       void *buf = heap_->Allocate(sizeof(Field));
-      fields_.push_back(new(buf)Field(*field));
+      if (field->GetTypeId() == TypeId::kTypeChar && !field->IsNull()) {
+        // the chars of other may live in its heap
+        auto chars = const_cast<char *>(field->GetData());
+        fields_.push_back(new(buf)Field(TypeId::kTypeChar, chars, field->GetLength(), true));
+      } else {
+        fields_.push_back(new(buf)Field(*field));
+      }
     }
   }
 
+  /**
+   * Row move function, the fields and their heap are handed over without copying
+   */
+  Row(Row &&other) noexcept
+      : rid_(other.rid_), fields_(std::move(other.fields_)), heap_(other.heap_), owns_heap_(other.owns_heap_) {
+    other.fields_.clear();
+    other.heap_ = nullptr;
+    other.owns_heap_ = false;
+  }
+
+  Row &operator=(Row &&other) noexcept {
+    std::swap(rid_, other.rid_);
+    std::swap(fields_, other.fields_);
+    std::swap(heap_, other.heap_);
+    std::swap(owns_heap_, other.owns_heap_);
+    return *this;
+  }
+
   virtual ~Row() {
-    delete heap_;
+    // the heap only releases the memory, a field may own a copy of its chars
+    for (auto field : fields_) {
+      field->~Field();
+    }
+    if (owns_heap_) {
+      delete heap_;
+    }
   }
 
   /**
@@ -100,6 +139,7 @@ private:
   RowId rid_{};
   std::vector<Field *> fields_;   /** Make sure that all fields are created by mem heap */
   MemHeap *heap_{nullptr};
+  bool owns_heap_{true};
 };
 
 #endif //MINISQL_TUPLE_H
@@ -0,0 +1,96 @@
+#ifndef MINISQL_ROW_CODEC_H
+#define MINISQL_ROW_CODEC_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/macros.h"
+#include "record/column.h"
+#include "record/type_id.h"
+#include "utils/mem_heap.h"
+
+class Row;
+
+/**
+ * Encoder and decoder of the rows of one schema, see Row for the format. It is built once with the schema: the
+ * layout is computed up front and every column becomes a step, fixed size columns first, then CHAR columns, each
+ * with its offset in the row. A row is encoded or decoded in one loop over the steps, reading and writing the
+ * fields directly instead of through virtual calls to Type.
+ * The layout is kept in arrays from the heap of the schema, whose destructor is not run when the heap is released.
+ */
+class RowCodec {
+public:
+  /**
+   * @param heap memory of the layout, the codec allocates and frees it itself if null
+   */
+  RowCodec(const std::vector<Column *> &columns, MemHeap *heap);
+
+  inline uint32_t GetNullBitmapSize() const { return null_bitmap_size_; }
+
+  /**
+   * @return offset of a fixed size value, or of the end offset of a CHAR value in the offset table
+   */
+  inline uint32_t GetFieldOffset(uint32_t idx) const { return field_offsets_[idx]; }
+
+  inline uint32_t GetVarTableOffset() const { return var_table_offset_; }
+
+  /**
+   * @return size of a row whose CHAR values are all empty, where the var length data starts
+   */
+  inline uint32_t GetFixedSize() const { return fixed_size_; }
+
+  /**
+   * @return whether column idx of the serialized row data is null
+   */
+  static inline bool IsNull(const char *data, uint32_t idx) { return (data[idx >> 3] >> (idx & 7)) & 1; }
+
+  /**
+   * @param[out] len length of the value
+   * @return value of column idx of the serialized row data, a CHAR value is not null terminated
+   */
+  inline const char *GetFieldData(const char *data, uint32_t idx, uint32_t *len) const {
+    ASSERT(idx < num_columns_, "Failed to access field");
+    uint32_t offset = field_offsets_[idx];
+    if (field_sizes_[idx] != 0) {
+      *len = field_sizes_[idx];
+      return data + offset;
+    }
+    uint32_t begin = offset == var_table_offset_ ? fixed_size_ : MACH_READ_UINT32(data + offset - sizeof(uint32_t));
+    *len = MACH_READ_UINT32(data + offset) - begin;
+    return data + begin;
+  }
+
+  uint32_t GetSerializedSize(const Row &row) const;
+
+  /**
+   * Note: writes exactly GetSerializedSize(row) bytes
+   */
+  uint32_t Encode(const Row &row, char *buf) const;
+
+  /**
+   * Append the fields of the serialized row data to row, allocated from the heap of the row
+   * @return size of the serialized row
+   */
+  uint32_t Decode(const char *buf, Row *row) const;
+
+private:
+  struct Step {
+    uint32_t column_;
+    uint32_t offset_;
+    TypeId type_;
+  };
+
+  uint32_t num_columns_;
+  uint32_t num_fixed_steps_{0};
+  uint32_t null_bitmap_size_;
+  uint32_t var_table_offset_{0};
+  uint32_t fixed_size_{0};
+  std::unique_ptr<char[]> owned_;       /** storage of the arrays below if there is no heap */
+  uint32_t *field_offsets_;
+  uint32_t *field_sizes_;               /** 0 for CHAR columns */
+  TypeId *field_types_;
+  Step *steps_;                         /** INT and FLOAT columns, then CHAR columns in the order of their values */
+};
+
+#endif  // MINISQL_ROW_CODEC_H
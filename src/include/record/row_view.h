@@ -0,0 +1,79 @@
+#ifndef MINISQL_ROW_VIEW_H
+#define MINISQL_ROW_VIEW_H
+
+#include "common/macros.h"
+#include "common/rowid.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * Read only view of a serialized row (see Row for the format), referencing the tuple bytes in a page.
+ * Columns are read at their offset in the row and CHAR values point into the page, so reading a row allocates
+ * nothing. The value of a null column reads as zero or as an empty string.
+ * The view is only valid while the page it references stays pinned and latched.
+ */
+class RowView {
+public:
+  RowView() = default;
+
+  RowView(const char *data, uint32_t size, Schema *schema, RowId rid)
+      : data_(data), size_(size), schema_(schema), rid_(rid) {}
+
+  inline RowId GetRowId() const { return rid_; }
+
+  inline const char *GetData() const { return data_; }
+
+  inline uint32_t GetSize() const { return size_; }
+
+  inline uint32_t GetFieldCount() const { return schema_->GetColumnCount(); }
+
+  inline bool IsNull(uint32_t idx) const { return RowCodec::IsNull(data_, idx); }
+
+  /**
+   * @return column idx as a field which does not own its data
+   */
+  Field GetField(uint32_t idx) const;
+
+  int32_t GetInt(uint32_t idx) const {
+    ASSERT(schema_->GetColumn(idx)->GetType() == TypeId::kTypeInt, "Not an int column.");
+    return MACH_READ_FROM(int32_t, GetFieldData(idx));
+  }
+
+  float GetFloat(uint32_t idx) const {
+    ASSERT(schema_->GetColumn(idx)->GetType() == TypeId::kTypeFloat, "Not a float column.");
+    return MACH_READ_FROM(float, GetFieldData(idx));
+  }
+
+  /**
+   * @param[out] len length of the string
+   * @return the string in the page, not null terminated
+   */
+  const char *GetChars(uint32_t idx, uint32_t *len) const {
+    ASSERT(schema_->GetColumn(idx)->GetType() == TypeId::kTypeChar, "Not a char column.");
+    return schema_->GetRowCodec().GetFieldData(data_, idx, len);
+  }
+
+  /**
+   * Copy the row out of the page
+   * @param[out] row row with the fields of this view, it must not have fields yet
+   */
+  void ToRow(Row *row) const;
+
+private:
+  /**
+   * @return the serialized bytes of a fixed size column
+   */
+  const char *GetFieldData(uint32_t idx) const {
+    ASSERT(idx < schema_->GetColumnCount(), "Failed to access field");
+    return data_ + schema_->GetRowCodec().GetFieldOffset(idx);
+  }
+
+private:
+  const char *data_{nullptr};
+  uint32_t size_{0};
+  Schema *schema_{nullptr};
+  RowId rid_{};
+};
+
+#endif  // MINISQL_ROW_VIEW_H
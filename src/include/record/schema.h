@@ -4,13 +4,18 @@
 #include "common/macros.h"
 #include "glog/logging.h"
 #include "record/column.h"
+#include "record/row_codec.h"
 
 #ifndef MINISQL_SCHEMA_H
 #define MINISQL_SCHEMA_H
 
 class Schema {
 public:
-  explicit Schema(const std::vector<Column *> columns) : columns_(std::move(columns)) {}
+  /**
+   * @param heap heap the schema is allocated from, if any, the codec keeps its layout there
+   */
+  explicit Schema(const std::vector<Column *> columns, MemHeap *heap = nullptr)
+      : columns_(std::move(columns)), codec_(columns_, heap) {}
 
   inline const std::vector<Column *> &GetColumns() const { return columns_; }
 
@@ -28,6 +33,11 @@ public:
 
   inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
 
+  /**
+   * @return codec of the rows of this schema, built with the schema
+   */
+  inline const RowCodec &GetRowCodec() const { return codec_; }
+
   /**
    * Shallow copy schema, only used in index
    *
@@ -41,7 +51,7 @@ public:
       cols.emplace_back(table_schema->columns_[i]);
     }
     void *buf = heap->Allocate(sizeof(Schema));
-    return new(buf) Schema(cols);
+    return new(buf) Schema(cols, heap);
   }
 
   /**
@@ -54,7 +64,7 @@ public:
       cols.push_back(new(buf)Column(from->GetColumn(i)));
     }
     void *buf = heap->Allocate(sizeof(Schema));
-    return new(buf) Schema(cols);
+    return new(buf) Schema(cols, heap);
   }
 
   /**
@@ -75,6 +85,7 @@ public:
 private:
   static constexpr uint32_t SCHEMA_MAGIC_NUM = 200715;
   std::vector<Column *> columns_;   /** don't need to delete pointer to column */
+  RowCodec codec_;
 };
 
 using IndexSchema = Schema;
@@ -0,0 +1,47 @@
+#ifndef MINISQL_ASYNC_IO_ENGINE_H
+#define MINISQL_ASYNC_IO_ENGINE_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+/**
+ * AsyncIOEngine runs submitted I/O requests on a pool of worker threads, so that up to num_threads blocking
+ * pread/pwrite calls are in flight at the same time. Requests are started in submission order.
+ */
+class AsyncIOEngine {
+public:
+  explicit AsyncIOEngine(size_t num_threads = DEFAULT_ASYNC_IO_THREADS);
+
+  /**
+   * Wait for every submitted request to finish, then stop the workers
+   */
+  ~AsyncIOEngine();
+
+  DISALLOW_COPY(AsyncIOEngine)
+
+  /**
+   * Queue a request, it is executed by one of the workers
+   */
+  void Submit(std::function<void()> request);
+
+  size_t GetNumThreads() const { return workers_.size(); }
+
+private:
+  void WorkerLoop();
+
+private:
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> requests_;
+  std::mutex latch_;
+  std::condition_variable cv_;
+  bool stop_{false};
+};
+
+#endif  // MINISQL_ASYNC_IO_ENGINE_H
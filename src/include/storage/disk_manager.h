@@ -2,28 +2,53 @@
 #define DISK_MGR_H
 
 #include <atomic>
-#include <fstream>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <sys/types.h>
+#include <utility>
+#include <vector>
 #include "common/config.h"
 #include "common/macros.h"
 #include "page/bitmap_page.h"
 #include "page/disk_file_meta_page.h"
+#include "storage/async_io_engine.h"
+
+/** Page number within the concatenation of all segment files, see DiskManager */
+using physical_page_id_t = int64_t;
 
 /**
  * DiskManager takes care of the allocation and de allocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
  *
- * Disk page storage format: (Free Page BitMap Size = PAGE_SIZE * 8, we note it as N)
+ * The database is split into segment files of at most EXTENTS_PER_SEGMENT extents. Segment 0 is the database file
+ * itself, segment k is the file named db_file.k, created when the first extent in it is added.
+ * Every segment has the storage format of a stand alone file (Free Page BitMap Size = PAGE_SIZE * 8, we note it as N)
  * | Meta Page | Free Page BitMap 1 | Page 1 | Page 2 | ....
  *      | Page N | Free Page BitMap 2 | Page N+1 | ... | Page 2N | ... |
+ * The meta page of segment 0 is the root of the database, it also records the number of segments and the extent
+ * reservations. Segment files are opened on first access, so I/O to different segments goes to different files.
+ *
+ * Pages are accessed with positional pread/pwrite on raw file descriptors, so reads and writes of different pages
+ * do not serialize on a shared stream cursor. Only page allocation, which updates the bitmaps, takes db_io_latch_.
+ * The *Async variants hand the requests to AsyncIOEngines, started on first use, to keep many I/Os in flight.
+ * Reads and writes have separate engines, so read completion callbacks can never hold up a waiting writer.
+ *
+ * Bitmap pages and meta pages are cached in memory once touched, so allocation costs no I/O. They are written back
+ * when the disk manager is closed.
  */
 class DiskManager {
 public:
-  explicit DiskManager(const std::string &db_file);
+  /**
+   * @param direct_io open the file with O_DIRECT to bypass the OS page cache, falls back to buffered I/O
+   * if the file system does not support it
+   */
+  explicit DiskManager(const std::string &db_file, bool direct_io = false);
 
-  ~DiskManager() {
+  virtual ~DiskManager() {
     if (!closed) {
       Close();
     }
@@ -32,20 +57,45 @@ public:
   /**
    * Read page from specific page_id
    * Note: page_id = 0 is reserved for disk meta page
+   * @return false on an I/O error, page_data is undefined then
    */
-  void ReadPage(page_id_t logical_page_id, char *page_data);
+  bool ReadPage(page_id_t logical_page_id, char *page_data);
 
   /**
    * Write data to specific page
    * Note: page_id = 0 is reserved for disk meta page
+   * @return false on an I/O error, the page on disk is undefined then
+   */
+  bool WritePage(page_id_t logical_page_id, const char *page_data);
+
+  /**
+   * Read page in the background
+   * @param page_data must stay valid until the returned future is ready
+   * @return future of the result of ReadPage
+   */
+  std::future<bool> ReadPageAsync(page_id_t logical_page_id, char *page_data);
+
+  /**
+   * Read page in the background and run callback on the I/O thread with the result of ReadPage
+   */
+  void ReadPageAsync(page_id_t logical_page_id, char *page_data, std::function<void(bool)> callback);
+
+  /**
+   * Write a batch of pages in the background, every page is an independent request so the whole batch can be in
+   * flight at once
+   * @param pages page data must stay valid until the returned future is ready
+   * @return future which is ready once every page of the batch is written, with the result of WritePage for each
+   * page in the order of pages
    */
-  void WritePage(page_id_t logical_page_id, const char *page_data);
+  std::future<std::vector<bool>> WritePagesAsync(std::vector<std::pair<page_id_t, const char *>> pages);
 
   /**
    * Get next free page from disk
-   * @return logical page id of allocated page
+   * @param owner_id if valid, the page is taken from the owner's reserved run of contiguous pages, a new run is
+   * reserved when it is used up
+   * @return logical page id of allocated page, INVALID_PAGE_ID if the database file is full
    */
-  page_id_t AllocatePage();
+  page_id_t AllocatePage(extent_owner_t owner_id = INVALID_EXTENT_OWNER);
 
   /**
    * Free this page and reset bit map
@@ -60,47 +110,169 @@ public:
   /**
    * Shut down the disk manager and close all the file resources.
    */
-  void Close();
+  virtual void Close();
 
   /**
    * Get Meta Page
    * Note: Used only for debug
    */
   char *GetMetaData() {
-    return meta_data_;
+    return GetSegmentMeta(0);
   }
 
+  /** @return true if the file was opened with O_DIRECT */
+  bool IsDirectIO() const { return direct_io_; }
+
+  /** @return number of segment files of the database */
+  uint32_t GetNumSegments();
+
   static constexpr size_t BITMAP_SIZE = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+  static constexpr uint32_t EXTENTS_PER_SEGMENT = DiskFileMetaPage::MAX_EXTENTS;
+  static constexpr page_id_t PAGES_PER_SEGMENT = EXTENTS_PER_SEGMENT * BITMAP_SIZE;
+  // meta page, then a bitmap page and BITMAP_SIZE pages per extent
+  static constexpr physical_page_id_t PHYSICAL_PAGES_PER_SEGMENT = 1 + EXTENTS_PER_SEGMENT * (BITMAP_SIZE + 1);
+
+protected:
+  /** An open segment file */
+  struct SegmentFile {
+    int fd_{-1};
+    // cached file size, reads beyond it return a zeroed page without a system call
+    std::atomic<off_t> file_size_{0};
+    std::once_flag open_;
+  };
 
-private:
   /**
    * Helper function to get disk file size
    */
-  int GetFileSize(const std::string &file_name);
+  static off_t GetFileSize(int fd);
 
   /**
-   * Read physical page from disk
+   * @return the segment file, opened or created on first call
    */
-  void ReadPhysicalPage(page_id_t physical_page_id, char *page_data);
+  SegmentFile &GetSegmentFile(uint32_t segment_id);
+
+  /**
+   * Read physical page from disk, a page past the end of the file reads as zeros
+   * @return false on an I/O error
+   */
+  virtual bool ReadPhysicalPage(physical_page_id_t physical_page_id, char *page_data);
 
   /**
    * Write data to physical page in disk
+   * @return false on an I/O error, including a short write
    */
-  void WritePhysicalPage(page_id_t physical_page_id, const char *page_data);
+  virtual bool WritePhysicalPage(physical_page_id_t physical_page_id, const char *page_data);
 
   /**
    * Map logical page id to physical page id
    */
-  page_id_t MapPageId(page_id_t logical_page_id);
+  physical_page_id_t MapPageId(page_id_t logical_page_id);
+
+  /**
+   * @return physical page id of the bitmap page of an extent
+   */
+  static physical_page_id_t MapBitmapId(uint32_t extent_id);
+
+  /**
+   * @return the async I/O engines, started on first call
+   */
+  AsyncIOEngine *GetReadEngine();
+
+  AsyncIOEngine *GetWriteEngine();
+
+  /**
+   * Wait for the outstanding asynchronous requests and stop the engines, caller must hold db_io_latch_
+   */
+  void StopIOEngines();
+
+  /**
+   * Write the dirty cached bitmap pages and the meta page back to disk, caller must hold db_io_latch_
+   * @return false if a page could not be written, it stays dirty
+   */
+  bool WriteBackMetaData();
+
+  /**
+   * @return the cached bitmap page of an extent, read from disk on first use, caller must hold db_io_latch_
+   */
+  BitmapPage<PAGE_SIZE> *GetBitmap(uint32_t extent_id);
+
+  /**
+   * @return the cached meta page of a segment, read from disk on first use, caller must hold db_io_latch_
+   * unless it is segment 0, which is loaded by the constructor
+   */
+  char *GetSegmentMeta(uint32_t segment_id);
 
 private:
-  // stream to write db file
-  std::fstream db_io_;
+  /**
+   * Allocate the lowest free page which is not part of a reserved run
+   */
+  page_id_t AllocateUnreserved();
+
+  /**
+   * Allocate the lowest free page of the run starting at first_page_id
+   * @return false if the run is full
+   */
+  bool AllocateInRun(page_id_t first_page_id, page_id_t &page_id);
+
+  /**
+   * Find the lowest run of free pages which is not reserved yet, adding an extent if needed
+   * @return false if the file can not hold another run
+   */
+  bool FindFreeRun(page_id_t &first_page_id);
+
+  /**
+   * @return the first page of the reserved run containing page_id, INVALID_PAGE_ID if it is not reserved
+   */
+  page_id_t GetReservedRun(page_id_t page_id);
+
+  /**
+   * Add an extent to the database if extent_id is the next one, starting a new segment if the last one is full
+   * @return false if the extent does not exist and can not be added
+   */
+  bool EnsureExtent(uint32_t extent_id);
+
+  /**
+   * @return total number of extents of all segments
+   */
+  uint32_t GetNumExtents();
+
+  /**
+   * @return meta page of the segment holding an extent
+   */
+  DiskFileMetaPage *GetExtentMeta(uint32_t extent_id) {
+    return reinterpret_cast<DiskFileMetaPage *>(GetSegmentMeta(extent_id / EXTENTS_PER_SEGMENT));
+  }
+
+  /**
+   * @return number of used pages of an extent
+   */
+  uint32_t &ExtentUsedPages(uint32_t extent_id) {
+    return GetExtentMeta(extent_id)->extent_used_page_[extent_id % EXTENTS_PER_SEGMENT];
+  }
+
+  /**
+   * Update the bitmap and the counters for a page taken from the bitmap of an extent
+   */
+  void MarkAllocated(uint32_t extent_id, uint32_t page_offset);
+
+protected:
+  SegmentFile segments_[DiskFileMetaPage::MAX_SEGMENTS];
+  bool direct_io_{false};
   std::string file_name_;
-  // with multiple buffer pool instances, need to protect file access
+  // protects the meta pages and the bitmap pages during allocation
   std::recursive_mutex db_io_latch_;
   bool closed{false};
-  char meta_data_[PAGE_SIZE];
+  // cached meta pages indexed by segment id
+  std::vector<std::unique_ptr<char[]>> meta_data_;
+  // cached bitmap pages indexed by extent id, and whether they differ from disk
+  std::vector<std::unique_ptr<BitmapPage<PAGE_SIZE>>> bitmaps_;
+  std::vector<bool> bitmap_dirty_;
+  // no extent before this one has a free page
+  uint32_t first_free_extent_{0};
+  std::unique_ptr<AsyncIOEngine> read_engine_;
+  std::unique_ptr<AsyncIOEngine> write_engine_;
+  std::once_flag read_engine_init_;
+  std::once_flag write_engine_init_;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef MINISQL_MMAP_DISK_MANAGER_H
+#define MINISQL_MMAP_DISK_MANAGER_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "storage/disk_manager.h"
+
+/**
+ * MmapDiskManager serves pages from a shared memory mapping of the database file instead of issuing one pread/pwrite
+ * per page, which removes the system call overhead for read-mostly workloads. The file layout, including the
+ * logical to physical mapping done by MapPageId, is unchanged, so files can be opened by either disk manager.
+ *
+ * A MAX_MAPPED_SIZE range of address space, enough for a full segment, is reserved up front and the first segment
+ * file is mapped into it from the start. When a write goes past the mapped area, the file is extended and only the
+ * new part is mapped at the end of the existing mapping, so pages never move and readers need no latch.
+ * Pages of the other segments are read and written with pread/pwrite.
+ */
+class MmapDiskManager : public DiskManager {
+public:
+  explicit MmapDiskManager(const std::string &db_file);
+
+  ~MmapDiskManager() override {
+    if (!closed) {
+      Close();
+    }
+  }
+
+  void Close() override;
+
+  /** @return number of bytes of the file currently mapped */
+  size_t GetMappedSize() const { return mapped_size_; }
+
+  static constexpr size_t MAX_MAPPED_SIZE = PHYSICAL_PAGES_PER_SEGMENT * PAGE_SIZE;
+  static constexpr size_t MIN_GROW_SIZE = 256 * PAGE_SIZE;
+
+protected:
+  bool ReadPhysicalPage(physical_page_id_t physical_page_id, char *page_data) override;
+
+  bool WritePhysicalPage(physical_page_id_t physical_page_id, const char *page_data) override;
+
+private:
+  /**
+   * Extend the file and the mapping so that the first size bytes are mapped
+   * @return false if the file can not be extended
+   */
+  bool Grow(size_t size);
+
+private:
+  char *mapping_{nullptr};
+  std::atomic<size_t> mapped_size_{0};
+  std::mutex grow_latch_;
+};
+
+#endif  // MINISQL_MMAP_DISK_MANAGER_H
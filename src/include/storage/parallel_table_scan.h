@@ -0,0 +1,50 @@
+#ifndef MINISQL_PARALLEL_TABLE_SCAN_H
+#define MINISQL_PARALLEL_TABLE_SCAN_H
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "record/column_batch.h"
+#include "storage/table_heap.h"
+
+/**
+ * Scans a table heap with several worker threads. The pages listed by the heap's page directory are split into
+ * morsels of consecutive pages, which the workers take one at a time, so a worker that gets slow pages does not
+ * hold up the others. Each worker decodes its pages into its own ColumnBatch.
+ */
+class ParallelTableScan {
+public:
+  /**
+   * @param num_workers number of threads, 0 for one per core
+   * @param morsel_size number of pages a worker takes at a time
+   */
+  explicit ParallelTableScan(TableHeap *table_heap, size_t num_workers = 0, size_t morsel_size = DEFAULT_MORSEL_SIZE);
+
+  /**
+   * Scan the whole table, returns once every tuple was passed to process
+   * @param process called on a worker thread for every batch, with the index of the worker so that partial
+   * results can be kept per worker without synchronization. The batch is reused after the call returns.
+   * @param[in] txn transaction performing the read
+   * @return false if the page directory or a page could not be read, process may have seen part of the table
+   */
+  bool Execute(const std::function<void(size_t worker_id, ColumnBatch &batch)> &process, Transaction *txn);
+
+  inline size_t GetNumWorkers() const { return num_workers_; }
+
+private:
+  /**
+   * Body of a worker thread
+   * @return false if a page could not be fetched
+   */
+  bool Work(size_t worker_id, const std::vector<page_id_t> &page_ids, std::atomic<size_t> &next_page,
+            const std::function<void(size_t worker_id, ColumnBatch &batch)> &process);
+
+private:
+  TableHeap *table_heap_;
+  size_t num_workers_;
+  size_t morsel_size_;
+};
+
+#endif  // MINISQL_PARALLEL_TABLE_SCAN_H
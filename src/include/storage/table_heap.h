@@ -1,14 +1,28 @@
 #ifndef MINISQL_TABLE_HEAP_H
 #define MINISQL_TABLE_HEAP_H
 
+#include <functional>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
+#include "page/free_space_map_page.h"
 #include "page/table_page.h"
 #include "storage/table_iterator.h"
 #include "transaction/log_manager.h"
 #include "transaction/lock_manager.h"
 
+/**
+ * Position of a batch scan, the page and slot the next TableHeap::ScanBatch call continues from
+ */
+struct BatchScanCursor {
+  page_id_t page_id_{INVALID_PAGE_ID};
+  uint32_t slot_num_{0};
+  std::shared_ptr<BufferAccessStrategy> strategy_;  /** buffer ring used to read the heap pages */
+};
+
 class TableHeap {
   friend class TableIterator;
+  friend class ParallelTableScan;
 
 public:
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
@@ -27,12 +41,22 @@ public:
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   * The page is picked by the free space map, a new page is appended if no page has enough room.
    * @param[in/out] row Tuple Row to insert, the rid of the inserted tuple is wrapped in object row
    * @param[in] txn The transaction performing the insert
    * @return true iff the insert is successful
    */
   bool InsertTuple(Row &row, Transaction *txn);
 
+  /**
+   * Append a batch of tuples at the tail of the table, packing each page before the next one is allocated.
+   * Free space in earlier pages is not looked for.
+   * @param[in/out] rows Tuple Rows to insert, the rid of each inserted tuple is wrapped in its row
+   * @param[in] txn The transaction performing the insert
+   * @return true iff all the rows are inserted, on failure the rows before the failing one stay inserted
+   */
+  bool InsertTuples(std::vector<Row> &rows, Transaction *txn);
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param[in] rid Resource id of the tuple of delete
@@ -72,15 +96,47 @@ public:
    */
   bool GetTuple(Row *row, Transaction *txn);
 
+  /**
+   * Visit every tuple in page order without materializing rows. Pages are read through a buffer ring like Begin.
+   * @param visitor called with a view of each tuple, valid during the call only, returning false stops the scan
+   * @param[in] txn transaction performing the read
+   */
+  void Scan(const std::function<bool(const RowView &)> &visitor, Transaction *txn);
+
+  /**
+   * Read the page directory, the ids of all pages of the table in chain order. The leaves of the free space map
+   * list the pages in the order they were appended, which is the chain order, so they double as the directory.
+   * Pages appended after the map filled up are found by following the chain from the last listed page.
+   * @param[out] page_ids ids of the pages
+   * @return false if a page of the directory can not be fetched
+   */
+  bool GetPageIds(std::vector<page_id_t> *page_ids);
+
+  /**
+   * @return cursor positioned at the first tuple, for ScanBatch
+   */
+  BatchScanCursor BeginBatchScan();
+
+  /**
+   * Fill batch with the next tuples of a scan, decoding a page at a time. The batch is reset first.
+   * @param[in/out] cursor position of the scan, advanced past the returned tuples
+   * @param[out] batch batch of the table's schema, all its tuples are selected
+   * @param[in] txn transaction performing the read
+   * @return false if a page can not be fetched, the cursor stays on that page. The scan is at the end of the table
+   * once the batch comes back empty.
+   */
+  bool ScanBatch(BatchScanCursor *cursor, ColumnBatch *batch, Transaction *txn);
+
   /**
    * Free table heap and release storage in disk file
    */
   void FreeHeap();
 
   /**
-   * @return the begin iterator of this table
+   * @param heap arena of the statement, the rows of the iterator are allocated from a child of it
+   * @return the begin iterator of this table, the iterator reads pages through its own buffer ring
    */
-  TableIterator Begin(Transaction *txn);
+  TableIterator Begin(Transaction *txn, ArenaMemHeap *heap = nullptr);
 
   /**
    * @return the end iterator of this table
@@ -92,6 +148,11 @@ public:
    */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /**
+   * @return the id of the root page of this table's free space map
+   */
+  inline page_id_t GetFreeSpaceMapPageId() const { return fsm_root_page_id_; }
+
 private:
   /**
    * create table heap and initialize first page
@@ -105,6 +166,7 @@ private:
     auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(first_page_id_));
     ASSERT(first_page != nullptr, "Couldn't create a page for the table heap.");
     first_page->Init(first_page_id_, PAGE_SIZE,log_manager_, txn);
+    CreateFreeSpaceMap(first_page);
     buffer_pool_manager_->UnpinPage(first_page_id_, true);
   };
 
@@ -117,11 +179,78 @@ private:
             first_page_id_(first_page_id),
             schema_(schema),
             log_manager_(log_manager),
-            lock_manager_(lock_manager) {}
+            lock_manager_(lock_manager) {
+    fsm_root_page_id_ = FindFreeSpaceMapRoot();
+  }
+
+  /**
+   * Create the free space map with the first page as its only entry
+   */
+  void CreateFreeSpaceMap(TablePage *first_page);
+
+  /**
+   * @return the free space map root, found through the leaf of the first page
+   */
+  page_id_t FindFreeSpaceMapRoot();
+
+  /**
+   * Insert into the last page of the chain, or into a new page appended to it
+   */
+  bool InsertIntoTail(Row &row, Transaction *txn);
+
+  /**
+   * @param root_page free space map root, pinned by the caller
+   * @return the last page of the chain, pinned and write latched, nullptr if a page can not be fetched
+   */
+  TablePage *LatchTailPage(Page *root_page);
+
+  /**
+   * Append a new page after last_page, which must be latched by the caller and is released by this call.
+   * The new page becomes the last page of the free space map.
+   * @param root_page free space map root, pinned by the caller
+   * @return the new page, pinned and write latched, nullptr if it can not be created
+   */
+  TablePage *AppendPage(Page *root_page, TablePage *last_page, Transaction *txn);
+
+  /**
+   * Unlatch and unpin a page the caller modified, then update its free space map entry
+   */
+  void ReleasePage(TablePage *page);
+
+  /**
+   * Pin the leaf the entry of a new page goes to, the last leaf or a new one if it is full. Caller holds the last
+   * page of the chain write latched.
+   * @param[out] leaf_page the leaf, nullptr if the map is full and the page stays untracked
+   * @return false if the leaf can not be fetched or created
+   */
+  bool PinLastLeaf(FreeSpaceMapPage *root, Page **leaf_page);
+
+  /**
+   * Add an entry for a new page to the leaf pinned by PinLastLeaf, which is unpinned. Caller holds the root write
+   * latched.
+   */
+  void TrackPage(FreeSpaceMapPage *root, Page *leaf_page, TablePage *page);
+
+  /**
+   * Update the free space map entry of a page, the page must not be latched by the caller
+   */
+  void UpdateFreeSpace(page_id_t fsm_page_id, page_id_t page_id, uint32_t free_space);
+
+  /**
+   * Same as UpdateFreeSpace, but the caller holds the root write latched and the root entry is updated as well
+   */
+  void SetFreeSpace(FreeSpaceMapPage *root, page_id_t fsm_page_id, page_id_t page_id, uint32_t free_space);
+
+  /**
+   * Copy the largest bucket of a leaf into its root entry, the caller must not hold a latch of the map
+   * @return false if a page of the map can not be fetched
+   */
+  bool RefreshLeafBucket(page_id_t leaf_page_id);
 
 private:
   BufferPoolManager *buffer_pool_manager_;
   page_id_t first_page_id_;
+  page_id_t fsm_root_page_id_{INVALID_PAGE_ID};
   Schema *schema_;
   [[maybe_unused]] LogManager *log_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
@@ -1,27 +1,46 @@
 #ifndef MINISQL_TABLE_ITERATOR_H
 #define MINISQL_TABLE_ITERATOR_H
 
+#include <memory>
+
+#include "buffer/buffer_access_strategy.h"
 #include "common/rowid.h"
 #include "record/row.h"
 #include "transaction/transaction.h"
+#include "utils/mem_heap.h"
 
 
 class TableHeap;
 
+class TablePage;
+
+/**
+ * The iterator keeps its current page pinned, so an increment within a page neither looks the page up in the
+ * buffer pool nor pins it again. The page is only read latched while the iterator moves or copies a tuple out,
+ * callers may update the table while they iterate.
+ * The current row is allocated from an arena of the iterator, which is reset on every increment. If the iterator is
+ * given the arena of a statement, its own arena is a child of it, released when the iterator is destroyed.
+ */
 class TableIterator {
 
 public:
   // you may define your own constructor based on your member variables
-  explicit TableIterator(TableHeap *table_heap, RowId rid, Transaction *txn);
+  explicit TableIterator(TableHeap *table_heap, RowId rid, Transaction *txn,
+                         std::shared_ptr<BufferAccessStrategy> strategy = nullptr, ArenaMemHeap *heap = nullptr);
+
+  explicit TableIterator(const TableIterator &other);
 
-  explicit TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), row_(new Row(*other.row_)), txn_(other.txn_) {}
+  /**
+   * Take over the row, the arena and the pin of other. other is left without a row, it compares equal to End() and
+   * copies as an end iterator, it may be destroyed or assigned to.
+   */
+  TableIterator(TableIterator &&other) noexcept;
 
   virtual ~TableIterator();
 
-  inline bool operator==(const TableIterator &itr) const;
+  bool operator==(const TableIterator &itr) const;
 
-  inline bool operator!=(const TableIterator &itr) const;
+  bool operator!=(const TableIterator &itr) const;
 
   const Row &operator*();
 
@@ -31,18 +50,44 @@ public:
 
   TableIterator operator++(int);
 
-  TableIterator &operator=(const TableIterator &other) {
-    table_heap_ = other.table_heap_;
-    row_ = (other.row_);
-    txn_ = other.txn_;
-    return *this;
-  }
+  TableIterator &operator=(const TableIterator &other);
+
+  TableIterator &operator=(TableIterator &&other) noexcept;
+
+private:
+  /**
+   * @return rid of the current row, the end for an iterator that was moved from
+   */
+  RowId GetRowId() const;
+
+  /**
+   * Release the current row and start an empty one at rid
+   */
+  void ResetRow(RowId rid);
+
+  /**
+   * Pin the page of rid and copy the tuple out of it, rid may be the end
+   */
+  void Load(RowId rid);
+
+  /**
+   * Unpin the current page
+   */
+  void Release();
+
+  /**
+   * @return a new arena for the rows, a child of the statement's arena if there is one
+   */
+  ArenaMemHeap *NewHeap() const;
 
 private:
  TableHeap *table_heap_;
  Row *row_;
  Transaction *txn_;
- // add your own private member variables here
+ std::shared_ptr<BufferAccessStrategy> strategy_;  /** buffer ring used to read the heap pages, may be null */
+ TablePage *page_{nullptr};                        /** pinned page of the current tuple, null at the end */
+ ArenaMemHeap *parent_heap_;                       /** arena of the statement, may be null */
+ ArenaMemHeap *heap_;                              /** memory of the current row, owned if there is no parent */
 };
 
 #endif //MINISQL_TABLE_ITERATOR_H
@@ -1,9 +1,15 @@
 #ifndef MINISQL_MEM_HEAP_H
 #define MINISQL_MEM_HEAP_H
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <iterator>
+#include <memory>
 #include <unordered_set>
+#include <vector>
+#include "common/config.h"
 #include "common/macros.h"
 
 class MemHeap {
@@ -54,4 +60,134 @@ private:
   std::unordered_set<void *> allocated_;
 };
 
+/**
+ * Hands out memory from chunks with a bump pointer, so an allocation is usually a pointer increment. Free does
+ * nothing, the memory is reclaimed all at once by Reset, ResetTo or the destructor. Chunks are kept on a reset and
+ * reused by later allocations. As with SimpleMemHeap, destructors of the objects are not run.
+ * Arenas form a tree, a child arena is released together with its parent, e.g. the memory of an iterator with the
+ * memory of the statement running it, or earlier by ReleaseChild.
+ */
+class ArenaMemHeap : public MemHeap {
+public:
+  /** Position in the arena, everything allocated after it is reclaimed by ResetTo */
+  struct Mark {
+    size_t chunk_;
+    size_t offset_;
+    size_t children_;  // number of children created before the mark
+  };
+
+  explicit ArenaMemHeap(size_t chunk_size = DEFAULT_ARENA_CHUNK_SIZE) : chunk_size_(chunk_size) {}
+
+  ~ArenaMemHeap() override {
+    for (auto &chunk : chunks_) {
+      free(chunk.data_);
+    }
+  }
+
+  void *Allocate(size_t size) override {
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (current_ >= chunks_.size() || offset_ + size > chunks_[current_].size_) {
+      NextChunk(size);
+    }
+    void *buf = chunks_[current_].data_ + offset_;
+    offset_ += size;
+    return buf;
+  }
+
+  void Free(void *ptr) override {}
+
+  /**
+   * @return an arena released by Reset, by ResetTo a mark taken before it was created, or by the destructor of this
+   * arena
+   */
+  ArenaMemHeap *CreateChild(size_t chunk_size = DEFAULT_ARENA_CHUNK_SIZE) {
+    children_.push_back(Child{num_children_++, std::make_unique<ArenaMemHeap>(chunk_size)});
+    return children_.back().arena_.get();
+  }
+
+  /**
+   * Release a child before this arena is reset, e.g. the arena of an iterator which is done while the statement
+   * goes on. A child that was already released by a reset is ignored.
+   */
+  void ReleaseChild(ArenaMemHeap *child) {
+    auto iter = std::find_if(children_.rbegin(), children_.rend(),
+                             [child](const Child &other) { return other.arena_.get() == child; });
+    if (iter != children_.rend()) {
+      children_.erase(std::next(iter).base());
+    }
+  }
+
+  inline Mark GetMark() const { return Mark{current_, offset_, num_children_}; }
+
+  /**
+   * Reclaim everything allocated and the children created since mark was taken
+   */
+  void ResetTo(const Mark &mark) {
+    ASSERT(mark.chunk_ < current_ || (mark.chunk_ == current_ && mark.offset_ <= offset_), "Mark is in the future.");
+    current_ = mark.chunk_;
+    offset_ = mark.offset_;
+    // children are ordered by their number
+    children_.erase(std::find_if(children_.begin(), children_.end(),
+                                 [&mark](const Child &child) { return child.number_ >= mark.children_; }),
+                    children_.end());
+  }
+
+  void Reset() { ResetTo(Mark{0, 0, 0}); }
+
+  /** @return number of bytes held in chunks by this arena and its children */
+  size_t GetCapacity() const {
+    size_t capacity = 0;
+    for (auto &chunk : chunks_) {
+      capacity += chunk.size_;
+    }
+    for (auto &child : children_) {
+      capacity += child.arena_->GetCapacity();
+    }
+    return capacity;
+  }
+
+private:
+  /**
+   * Move on to the next chunk with room for size bytes, a kept chunk which is too small is replaced.
+   * The first chunk is only allocated on the first allocation.
+   */
+  void NextChunk(size_t size) {
+    if (current_ < chunks_.size()) {
+      current_++;
+    }
+    offset_ = 0;
+    if (current_ < chunks_.size() && chunks_[current_].size_ >= size) {
+      return;
+    }
+    size_t chunk_size = std::max(chunk_size_, size);
+    char *data = static_cast<char *>(malloc(chunk_size));
+    ASSERT(data != nullptr, "Out of memory exception");
+    if (current_ < chunks_.size()) {
+      free(chunks_[current_].data_);
+      chunks_[current_] = Chunk{data, chunk_size};
+    } else {
+      chunks_.push_back(Chunk{data, chunk_size});
+    }
+  }
+
+private:
+  struct Chunk {
+    char *data_;
+    size_t size_;
+  };
+
+  struct Child {
+    size_t number_;                       // children created before it
+    std::unique_ptr<ArenaMemHeap> arena_;
+  };
+
+  static constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+  size_t chunk_size_;
+  std::vector<Chunk> chunks_;
+  std::vector<Child> children_;
+  size_t num_children_{0};  // children ever created, a mark counts the ones created before it
+  size_t current_{0};   // chunk allocations are taken from
+  size_t offset_{0};    // first free byte of the current chunk
+};
+
 #endif //MINISQL_MEM_HEAP_H
@@ -123,7 +123,7 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
 
   // ask for new page
   page_id_t root_page_id;
-  auto new_page = buffer_pool_manager_->NewPage(root_page_id);
+  auto new_page = buffer_pool_manager_->NewPage(root_page_id, DiskFileMetaPage::IndexOwner(index_id_));
   // string exception_ = "out of memory";
   // if null
   if(new_page == nullptr)
@@ -208,7 +208,7 @@ N *BPLUSTREE_TYPE::Split(N *node) {
   // allocate a new page
   ASSERT(node!=nullptr,"node is null!");
   page_id_t new_page_id;
-  Page *new_page=buffer_pool_manager_->NewPage(new_page_id);
+  Page *new_page=buffer_pool_manager_->NewPage(new_page_id, DiskFileMetaPage::IndexOwner(index_id_));
   // out of memory
   if(new_page == nullptr)
   {
@@ -270,7 +270,7 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
   if (old_node->IsRootPage()){
     // set a new root page
     page_id_t NewRootPageId = INVALID_PAGE_ID;
-    Page *page = buffer_pool_manager_->NewPage(NewRootPageId);
+    Page *page = buffer_pool_manager_->NewPage(NewRootPageId, DiskFileMetaPage::IndexOwner(index_id_));
     InternalPage*New_Root_Page = reinterpret_cast<InternalPage *>(page->GetData());
     ASSERT(new_node!=nullptr,"newpage is null!");
     // update root page id
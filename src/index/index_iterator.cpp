@@ -22,7 +22,10 @@ INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
     if (next_page_id!=INVALID_PAGE_ID){//last node
       index = 0;
       Page* page = buffer_pool_manager->FetchPage(next_page_id);
+      buffer_pool_manager->UnpinPage(leaf_page->GetPageId(), false);
       leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+      // keep the read ahead window DEFAULT_PREFETCH_DEPTH leaves in front of the scan
+      buffer_pool_manager->PrefetchChain(leaf_page->GetNextPageId(), LeafPage::GetNextPageId);
     }
     else{
       index ++;
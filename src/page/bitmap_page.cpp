@@ -1,27 +1,67 @@
+#include <cstring>
+
 #include "page/bitmap_page.h"
 
+template <size_t PageSize>
+uint64_t BitmapPage<PageSize>::LoadWord(size_t word_index) const {
+  uint64_t word;
+  memcpy(&word, bytes + word_index * sizeof(uint64_t), sizeof(uint64_t));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  word = __builtin_bswap64(word);
+#endif
+  return word;
+}
+
 template <size_t PageSize>
 bool BitmapPage<PageSize>::AllocatePage(uint32_t &page_offset) {
-  size_t i;
-  for (i = 0; i < page_allocated_; i++) {
-    if (bytes[i >> 3] & (1 << (7 - (i % 8))))
-      continue;
-    else
-      break;
+  // no free page precedes next_free_page_, so the first free page from there is the lowest one
+  if (!FindFreePage(next_free_page_, page_offset)) {
+    return false;
+  }
+  return MarkAllocated(page_offset);
+}
+
+template <size_t PageSize>
+bool BitmapPage<PageSize>::MarkAllocated(uint32_t page_offset) {
+  if (!IsPageFree(page_offset)) {
+    return false;
+  }
+  bytes[page_offset >> 3] |= (1 << (7 - (page_offset % 8)));
+  page_allocated_++;
+  if (page_offset == next_free_page_) {
+    next_free_page_++;
   }
-  if ((i == page_allocated_) && (page_allocated_ >> 3 == MAX_CHARS))
+  return true;
+}
+
+template <size_t PageSize>
+bool BitmapPage<PageSize>::FindFreePage(uint32_t from, uint32_t &page_offset) const {
+  if (page_allocated_ == GetMaxSupportedSize()) {
     return false;
-  else {
-    if (i == page_allocated_) {
-      bytes[page_allocated_ >> 3] |= (1 << (7 - (page_allocated_ % 8)));
-      page_offset = page_allocated_;
-    } else {
-      bytes[i >> 3] |= (1 << (7 - (i % 8)));
-      page_offset = i;
+  }
+  size_t word_index = from / 64;
+  // pages before from in its word are skipped
+  uint64_t skip_mask = from % 64 == 0 ? 0 : ~(~0ULL >> (from % 64));
+  for (; word_index < MAX_WORDS; word_index++, skip_mask = 0) {
+    uint64_t free_bits = ~(LoadWord(word_index) | skip_mask);
+    if (free_bits != 0) {
+      page_offset = word_index * 64 + __builtin_clzll(free_bits);
+      return true;
+    }
+  }
+  return false;
+}
+
+template <size_t PageSize>
+bool BitmapPage<PageSize>::FindFreeRun(uint32_t from, uint32_t &page_offset) const {
+  static_assert(RUN_SIZE == 64, "a run is one word of the bitmap");
+  for (size_t word_index = from / 64; word_index < MAX_WORDS; word_index++) {
+    if (LoadWord(word_index) == 0) {
+      page_offset = word_index * 64;
+      return true;
     }
-    page_allocated_++;
-    return true;
   }
+  return false;
 }
 
 template <size_t PageSize>
@@ -29,6 +69,9 @@ bool BitmapPage<PageSize>::DeAllocatePage(uint32_t page_offset) {
   if (bytes[page_offset >> 3] & (1 << (7 - (page_offset % 8)))) {
     bytes[page_offset >> 3] &= (~(1 << (7 - (page_offset % 8))));
     page_allocated_--;
+    if (page_offset < next_free_page_) {
+      next_free_page_ = page_offset;
+    }
     return true;
   } else
     return false;
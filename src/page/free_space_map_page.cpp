@@ -0,0 +1,34 @@
+#include "page/free_space_map_page.h"
+
+void FreeSpaceMapPage::Append(page_id_t page_id, uint8_t bucket) {
+  ASSERT(!IsFull(), "Free space map page is full.");
+  page_ids_[count_] = page_id;
+  buckets_[count_] = bucket;
+  count_++;
+}
+
+int FreeSpaceMapPage::FindSlot(uint8_t bucket) const {
+  for (uint32_t i = 0; i < count_; i++) {
+    if (buckets_[i] >= bucket) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+int FreeSpaceMapPage::FindPage(page_id_t page_id) const {
+  for (uint32_t i = 0; i < count_; i++) {
+    if (page_ids_[i] == page_id) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+uint8_t FreeSpaceMapPage::GetMaxBucket() const {
+  uint8_t max_bucket = 0;
+  for (uint32_t i = 0; i < count_; i++) {
+    max_bucket = std::max(max_bucket, buckets_[i]);
+  }
+  return max_bucket;
+}
@@ -6,26 +6,29 @@ void TablePage::Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr,
   SetNextPageId(INVALID_PAGE_ID);
   SetFreeSpacePointer(PAGE_SIZE);
   SetTupleCount(0);
+  SetFreeSpaceMapPageId(INVALID_PAGE_ID);
+  SetFreeSlotHead(INVALID_SLOT);
+  SetHoleSize(0);
 }
 
 bool TablePage::InsertTuple(Row &row, Schema *schema, Transaction *txn,
                             LockManager *lock_manager, LogManager *log_manager) {
   uint32_t serialized_size = row.GetSerializedSize(schema);
   ASSERT(serialized_size > 0, "Can not have empty row.");
-  if (GetFreeSpaceRemaining() < serialized_size + SIZE_TUPLE) {
+  // Reuse the first free slot if there is one.
+  uint32_t i = GetFreeSlotHead();
+  bool reuse_slot = i != INVALID_SLOT;
+  uint32_t required_size = serialized_size + (reuse_slot ? 0 : SIZE_TUPLE);
+  if (GetFreeSpaceRemaining() < required_size) {
     return false;
   }
-  // Try to find a free slot to reuse.
-  uint32_t i;
-  for (i = 0; i < GetTupleCount(); i++) {
-    // If the slot is empty, i.e. its tuple has size 0,
-    if (GetTupleSize(i) == 0) {
-      // Then we break out of the loop at index i.
-      break;
-    }
+  if (GetContiguousFreeSpace() < required_size) {
+    Compact();
   }
-  if (i == GetTupleCount() && GetFreeSpaceRemaining() < serialized_size + SIZE_TUPLE) {
-    return false;
+  if (reuse_slot) {
+    SetFreeSlotHead(GetTupleOffsetAtSlot(i));
+  } else {
+    i = GetTupleCount();
   }
   // Otherwise we claim available free space..
   SetFreeSpacePointer(GetFreeSpacePointer() - serialized_size);
@@ -84,21 +87,22 @@ bool TablePage::UpdateTuple(const Row &new_row, Row *old_row, Schema *schema,
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
   uint32_t __attribute__((unused)) read_bytes = old_row->DeserializeFrom(GetData() + tuple_offset, schema);
   ASSERT(tuple_size == read_bytes, "Unexpected behavior in tuple deserialize.");
-  uint32_t free_space_pointer = GetFreeSpacePointer();
-  ASSERT(tuple_offset >= free_space_pointer, "Offset should appear after current free space position.");
-  memmove(GetData() + free_space_pointer + tuple_size - serialized_size, GetData() + free_space_pointer,
-          tuple_offset - free_space_pointer);
-  SetFreeSpacePointer(free_space_pointer + tuple_size - serialized_size);
-  new_row.SerializeTo(GetData() + tuple_offset + tuple_size - serialized_size, schema);
-  SetTupleSize(slot_num, serialized_size);
-
-  // Update all tuple offsets.
-  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
-    uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
-    if (GetTupleSize(i) > 0 && tuple_offset_i < tuple_offset + tuple_size) {
-      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size - new_row.GetSerializedSize(schema));
+  if (serialized_size <= tuple_size) {
+    // Overwrite in place, the rest of the old tuple becomes a hole.
+    new_row.SerializeTo(GetData() + tuple_offset, schema);
+    SetHoleSize(GetHoleSize() + tuple_size - serialized_size);
+  } else {
+    // Move the tuple to the free space, the slot is left out of a compaction until it points there.
+    ReleaseTupleSpace(tuple_offset, tuple_size);
+    SetTupleSize(slot_num, 0);
+    if (GetContiguousFreeSpace() < serialized_size) {
+      Compact();
     }
+    SetFreeSpacePointer(GetFreeSpacePointer() - serialized_size);
+    new_row.SerializeTo(GetData() + GetFreeSpacePointer(), schema);
+    SetTupleOffsetAtSlot(slot_num, GetFreeSpacePointer());
   }
+  SetTupleSize(slot_num, serialized_size);
   return true;
 }
 
@@ -113,22 +117,45 @@ void TablePage::ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_
     tuple_size = UnsetDeletedFlag(tuple_size);
   }
 
-  uint32_t free_space_pointer = GetFreeSpacePointer();
-  ASSERT(tuple_offset >= free_space_pointer, "Free space appears before tuples.");
-
-  memmove(GetData() + free_space_pointer + tuple_size, GetData() + free_space_pointer,
-          tuple_offset - free_space_pointer);
-  SetFreeSpacePointer(free_space_pointer + tuple_size);
+  // The slot is free already.
+  if (tuple_size == 0) {
+    return;
+  }
+  ASSERT(tuple_offset >= GetFreeSpacePointer(), "Free space appears before tuples.");
+  ReleaseTupleSpace(tuple_offset, tuple_size);
+  // Push the slot onto the free slot list.
   SetTupleSize(slot_num, 0);
-  SetTupleOffsetAtSlot(slot_num, 0);
+  SetTupleOffsetAtSlot(slot_num, GetFreeSlotHead());
+  SetFreeSlotHead(slot_num);
+}
 
-  // Update all tuple offsets.
-  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
-    uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
-    if (GetTupleSize(i) != 0 && tuple_offset_i < tuple_offset) {
-      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size);
+void TablePage::ReleaseTupleSpace(uint32_t tuple_offset, uint32_t tuple_size) {
+  if (tuple_offset == GetFreeSpacePointer()) {
+    // The tuple borders the free space, no hole is left.
+    SetFreeSpacePointer(tuple_offset + tuple_size);
+  } else {
+    SetHoleSize(GetHoleSize() + tuple_size);
+  }
+}
+
+void TablePage::Compact() {
+  // Copy the tuples out, then write them back packed in slot order.
+  char buffer[PAGE_SIZE];
+  uint32_t free_space_pointer = GetFreeSpacePointer();
+  memcpy(buffer + free_space_pointer, GetData() + free_space_pointer, PAGE_SIZE - free_space_pointer);
+  free_space_pointer = PAGE_SIZE;
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    // Tuples marked as deleted still own their bytes.
+    uint32_t tuple_size = UnsetDeletedFlag(GetTupleSize(i));
+    if (tuple_size == 0) {
+      continue;
     }
+    free_space_pointer -= tuple_size;
+    memcpy(GetData() + free_space_pointer, buffer + GetTupleOffsetAtSlot(i), tuple_size);
+    SetTupleOffsetAtSlot(i, free_space_pointer);
   }
+  SetFreeSpacePointer(free_space_pointer);
+  SetHoleSize(0);
 }
 
 void TablePage::RollbackDelete(const RowId &rid, Transaction *txn, LogManager *log_manager) {
@@ -163,6 +190,31 @@ bool TablePage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager
   return true;
 }
 
+bool TablePage::GetTupleView(const RowId &rid, Schema *schema, RowView *view) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount()) {
+    return false;
+  }
+  uint32_t tuple_size = GetTupleSize(slot_num);
+  if (IsDeleted(tuple_size)) {
+    return false;
+  }
+  *view = RowView(GetData() + GetTupleOffsetAtSlot(slot_num), tuple_size, schema, rid);
+  return true;
+}
+
+uint32_t TablePage::DecodeTuples(uint32_t from_slot, ColumnBatch *batch) {
+  uint32_t tuple_count = GetTupleCount();
+  page_id_t page_id = GetTablePageId();
+  uint32_t slot_num = from_slot;
+  for (; slot_num < tuple_count && !batch->IsFull(); slot_num++) {
+    if (!IsDeleted(GetTupleSize(slot_num))) {
+      batch->Append(GetData() + GetTupleOffsetAtSlot(slot_num), RowId(page_id, slot_num));
+    }
+  }
+  return slot_num;
+}
+
 bool TablePage::GetFirstTupleRid(RowId *first_rid) {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); i++) {
@@ -0,0 +1,194 @@
+#include "record/column_batch.h"
+
+#include <algorithm>
+#include <cstring>
+
+ColumnVector::ColumnVector(TypeId type_id, uint32_t capacity) : type_id_(type_id), nulls_(capacity, 0) {
+  switch (type_id) {
+    case TypeId::kTypeInt:
+      ints_.resize(capacity);
+      break;
+    case TypeId::kTypeFloat:
+      floats_.resize(capacity);
+      break;
+    case TypeId::kTypeChar:
+      offsets_.resize(capacity + 1, 0);
+      break;
+    default:
+      ASSERT(false, "Unsupported column type.");
+  }
+}
+
+ColumnBatch::ColumnBatch(Schema *schema, uint32_t capacity)
+    : schema_(schema), capacity_(capacity), row_ids_(capacity), selection_(capacity) {
+  columns_.reserve(schema->GetColumnCount());
+  for (auto column : schema->GetColumns()) {
+    columns_.emplace_back(column->GetType(), capacity);
+  }
+}
+
+void ColumnBatch::Append(const char *tuple, RowId rid) {
+  ASSERT(!IsFull(), "Column batch is full.");
+  // one switch per value, no virtual call through Type
+  const RowCodec &codec = schema_->GetRowCodec();
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    auto &column = columns_[i];
+    column.nulls_[size_] = RowCodec::IsNull(tuple, i);
+    switch (column.type_id_) {
+      case TypeId::kTypeInt:
+        column.ints_[size_] = MACH_READ_FROM(int32_t, tuple + codec.GetFieldOffset(i));
+        break;
+      case TypeId::kTypeFloat:
+        column.floats_[size_] = MACH_READ_FROM(float, tuple + codec.GetFieldOffset(i));
+        break;
+      case TypeId::kTypeChar: {
+        uint32_t len;
+        const char *chars = codec.GetFieldData(tuple, i, &len);
+        column.bytes_.insert(column.bytes_.end(), chars, chars + len);
+        column.offsets_[size_ + 1] = column.offsets_[size_] + len;
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  row_ids_[size_] = rid;
+  selection_[selected_count_++] = size_;
+  size_++;
+}
+
+void ColumnBatch::Reset() {
+  for (auto &column : columns_) {
+    column.bytes_.clear();
+  }
+  size_ = 0;
+  selected_count_ = 0;
+}
+
+void ColumnVector::CopyPrefixes(uint32_t count, char *prefixes) const {
+  ASSERT(type_id_ == TypeId::kTypeChar, "Not a char column.");
+  memset(prefixes, 0, static_cast<size_t>(count) * FilterKernels::PREFIX_SIZE);
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t len = std::min(offsets_[i + 1] - offsets_[i], FilterKernels::PREFIX_SIZE);
+    memcpy(prefixes + i * FilterKernels::PREFIX_SIZE, bytes_.data() + offsets_[i], len);
+  }
+}
+
+void ColumnBatch::Filter(uint32_t idx, CompareOp op, int32_t constant) {
+  auto &column = columns_[idx];
+  ASSERT(column.type_id_ == TypeId::kTypeInt, "Not an int column.");
+  ReserveFilterBuffers(false);
+  FilterKernels::Compare(column.ints_.data(), size_, op, constant, bitmap_.data());
+  Select(column, nullptr, op, nullptr, 0, false);
+}
+
+void ColumnBatch::Filter(uint32_t idx, CompareOp op, float constant) {
+  auto &column = columns_[idx];
+  ASSERT(column.type_id_ == TypeId::kTypeFloat, "Not a float column.");
+  ReserveFilterBuffers(false);
+  FilterKernels::Compare(column.floats_.data(), size_, op, constant, bitmap_.data());
+  Select(column, nullptr, op, nullptr, 0, false);
+}
+
+void ColumnBatch::Filter(uint32_t idx, CompareOp op, const char *chars, uint32_t len) {
+  auto &column = columns_[idx];
+  ASSERT(column.type_id_ == TypeId::kTypeChar, "Not a char column.");
+  ReserveFilterBuffers(true);
+  char constant[FilterKernels::PREFIX_SIZE] = {0};
+  memcpy(constant, chars, std::min(len, FilterKernels::PREFIX_SIZE));
+  column.CopyPrefixes(size_, prefixes_.data());
+  FilterKernels::ComparePrefixes(prefixes_.data(), size_, op, constant, bitmap_.data());
+  FilterKernels::ComparePrefixes(prefixes_.data(), size_, CompareOp::kEqual, constant, ties_.data());
+  Select(column, nullptr, op, chars, len, true);
+}
+
+void ColumnBatch::FilterColumns(uint32_t left, CompareOp op, uint32_t right) {
+  auto &left_column = columns_[left];
+  auto &right_column = columns_[right];
+  ASSERT(left_column.type_id_ == right_column.type_id_, "Columns are not comparable.");
+  ReserveFilterBuffers(left_column.type_id_ == TypeId::kTypeChar);
+  switch (left_column.type_id_) {
+    case TypeId::kTypeInt:
+      FilterKernels::Compare(left_column.ints_.data(), right_column.ints_.data(), size_, op, bitmap_.data());
+      break;
+    case TypeId::kTypeFloat:
+      FilterKernels::Compare(left_column.floats_.data(), right_column.floats_.data(), size_, op, bitmap_.data());
+      break;
+    case TypeId::kTypeChar:
+      left_column.CopyPrefixes(size_, prefixes_.data());
+      right_column.CopyPrefixes(size_, right_prefixes_.data());
+      FilterKernels::ComparePrefixes(prefixes_.data(), right_prefixes_.data(), size_, op, bitmap_.data());
+      FilterKernels::ComparePrefixes(prefixes_.data(), right_prefixes_.data(), size_, CompareOp::kEqual,
+                                     ties_.data());
+      break;
+    default:
+      ASSERT(false, "Unsupported column type.");
+  }
+  Select(left_column, &right_column, op, nullptr, 0, left_column.type_id_ == TypeId::kTypeChar);
+}
+
+namespace {
+
+/** @return the comparison of the full strings, like TypeChar */
+int CompareChars(const char *left, uint32_t left_len, const char *right, uint32_t right_len) {
+  int cmp = memcmp(left, right, std::min(left_len, right_len));
+  if (cmp == 0 && left_len != right_len) {
+    cmp = left_len < right_len ? -1 : 1;
+  }
+  return cmp;
+}
+
+bool IsQualified(CompareOp op, int cmp) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return cmp == 0;
+    case CompareOp::kNotEqual:
+      return cmp != 0;
+    case CompareOp::kLessThan:
+      return cmp < 0;
+    case CompareOp::kLessThanEquals:
+      return cmp <= 0;
+    case CompareOp::kGreaterThan:
+      return cmp > 0;
+    default:
+      return cmp >= 0;
+  }
+}
+
+}  // namespace
+
+void ColumnBatch::Select(const ColumnVector &left, const ColumnVector *right, CompareOp op, const char *chars,
+                         uint32_t len, bool check_ties) {
+  uint32_t selected_count = 0;
+  for (uint32_t i = 0; i < selected_count_; i++) {
+    uint32_t pos = selection_[i];
+    if (left.nulls_[pos] || (right != nullptr && right->nulls_[pos])) {
+      continue;
+    }
+    bool qualified;
+    if (check_ties && FilterKernels::IsSet(ties_.data(), pos)) {
+      uint32_t left_len, right_len = len;
+      const char *left_chars = left.GetChars(pos, &left_len);
+      const char *right_chars = right == nullptr ? chars : right->GetChars(pos, &right_len);
+      qualified = IsQualified(op, CompareChars(left_chars, left_len, right_chars, right_len));
+    } else {
+      qualified = FilterKernels::IsSet(bitmap_.data(), pos);
+    }
+    if (qualified) {
+      selection_[selected_count++] = pos;
+    }
+  }
+  selected_count_ = selected_count;
+}
+
+void ColumnBatch::ReserveFilterBuffers(bool prefixes) {
+  // allocated by the first filter, kept for the next batches
+  if (bitmap_.empty()) {
+    bitmap_.resize(FilterKernels::GetBitmapSize(capacity_));
+    ties_.resize(FilterKernels::GetBitmapSize(capacity_));
+  }
+  if (prefixes && prefixes_.empty()) {
+    prefixes_.resize(static_cast<size_t>(capacity_) * FilterKernels::PREFIX_SIZE);
+    right_prefixes_.resize(static_cast<size_t>(capacity_) * FilterKernels::PREFIX_SIZE);
+  }
+}
@@ -0,0 +1,278 @@
+#include "record/filter_kernels.h"
+
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+template <CompareOp op>
+inline bool CompareResult(int cmp) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return cmp == 0;
+    case CompareOp::kNotEqual:
+      return cmp != 0;
+    case CompareOp::kLessThan:
+      return cmp < 0;
+    case CompareOp::kLessThanEquals:
+      return cmp <= 0;
+    case CompareOp::kGreaterThan:
+      return cmp > 0;
+    default:
+      return cmp >= 0;
+  }
+}
+
+template <CompareOp op, typename T>
+inline bool CompareValues(T left, T right) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return left == right;
+    case CompareOp::kNotEqual:
+      return left != right;
+    case CompareOp::kLessThan:
+      return left < right;
+    case CompareOp::kLessThanEquals:
+      return left <= right;
+    case CompareOp::kGreaterThan:
+      return left > right;
+    default:
+      return left >= right;
+  }
+}
+
+#if defined(__AVX2__)
+constexpr uint32_t LANES = 8;
+
+/** @return one bit per lane */
+template <CompareOp op>
+inline uint64_t CompareLanes(__m256i left, __m256i right) {
+  __m256i mask;
+  switch (op) {
+    case CompareOp::kEqual:
+      mask = _mm256_cmpeq_epi32(left, right);
+      break;
+    case CompareOp::kNotEqual:
+      mask = _mm256_xor_si256(_mm256_cmpeq_epi32(left, right), _mm256_set1_epi32(-1));
+      break;
+    case CompareOp::kLessThan:
+      mask = _mm256_cmpgt_epi32(right, left);
+      break;
+    case CompareOp::kLessThanEquals:
+      mask = _mm256_xor_si256(_mm256_cmpgt_epi32(left, right), _mm256_set1_epi32(-1));
+      break;
+    case CompareOp::kGreaterThan:
+      mask = _mm256_cmpgt_epi32(left, right);
+      break;
+    default:
+      mask = _mm256_xor_si256(_mm256_cmpgt_epi32(right, left), _mm256_set1_epi32(-1));
+      break;
+  }
+  return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+}
+
+template <CompareOp op>
+inline uint64_t CompareLanes(__m256 left, __m256 right) {
+  // ordered predicates are false for NaN, only != is true, like the scalar operators
+  switch (op) {
+    case CompareOp::kEqual:
+      return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(left, right, _CMP_EQ_OQ)));
+    case CompareOp::kNotEqual:
+      return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(left, right, _CMP_NEQ_UQ)));
+    case CompareOp::kLessThan:
+      return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(left, right, _CMP_LT_OQ)));
+    case CompareOp::kLessThanEquals:
+      return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(left, right, _CMP_LE_OQ)));
+    case CompareOp::kGreaterThan:
+      return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(left, right, _CMP_GT_OQ)));
+    default:
+      return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(left, right, _CMP_GE_OQ)));
+  }
+}
+
+inline __m256i Load(const int32_t *values) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values)); }
+
+inline __m256 Load(const float *values) { return _mm256_loadu_ps(values); }
+
+inline __m256i Broadcast(int32_t value) { return _mm256_set1_epi32(value); }
+
+inline __m256 Broadcast(float value) { return _mm256_set1_ps(value); }
+#elif defined(__SSE4_2__)
+constexpr uint32_t LANES = 4;
+
+template <CompareOp op>
+inline uint64_t CompareLanes(__m128i left, __m128i right) {
+  __m128i mask;
+  switch (op) {
+    case CompareOp::kEqual:
+      mask = _mm_cmpeq_epi32(left, right);
+      break;
+    case CompareOp::kNotEqual:
+      mask = _mm_xor_si128(_mm_cmpeq_epi32(left, right), _mm_set1_epi32(-1));
+      break;
+    case CompareOp::kLessThan:
+      mask = _mm_cmplt_epi32(left, right);
+      break;
+    case CompareOp::kLessThanEquals:
+      mask = _mm_xor_si128(_mm_cmpgt_epi32(left, right), _mm_set1_epi32(-1));
+      break;
+    case CompareOp::kGreaterThan:
+      mask = _mm_cmpgt_epi32(left, right);
+      break;
+    default:
+      mask = _mm_xor_si128(_mm_cmplt_epi32(left, right), _mm_set1_epi32(-1));
+      break;
+  }
+  return static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+}
+
+template <CompareOp op>
+inline uint64_t CompareLanes(__m128 left, __m128 right) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpeq_ps(left, right)));
+    case CompareOp::kNotEqual:
+      return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpneq_ps(left, right)));
+    case CompareOp::kLessThan:
+      return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmplt_ps(left, right)));
+    case CompareOp::kLessThanEquals:
+      return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(left, right)));
+    case CompareOp::kGreaterThan:
+      return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpgt_ps(left, right)));
+    default:
+      return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(left, right)));
+  }
+}
+
+inline __m128i Load(const int32_t *values) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(values)); }
+
+inline __m128 Load(const float *values) { return _mm_loadu_ps(values); }
+
+inline __m128i Broadcast(int32_t value) { return _mm_set1_epi32(value); }
+
+inline __m128 Broadcast(float value) { return _mm_set1_ps(value); }
+#endif
+
+/**
+ * Compare count values of left with right, or with constant if right is null
+ */
+template <CompareOp op, typename T>
+void CompareArrays(const T *left, const T *right, T constant, uint32_t count, uint64_t *bitmap) {
+  memset(bitmap, 0, FilterKernels::GetBitmapSize(count) * sizeof(uint64_t));
+  uint32_t i = 0;
+#if defined(__AVX2__) || defined(__SSE4_2__)
+  // a group of lanes never crosses a bitmap word
+  auto broadcast = Broadcast(constant);
+  if (right == nullptr) {
+    for (; i + LANES <= count; i += LANES) {
+      bitmap[i >> 6] |= CompareLanes<op>(Load(left + i), broadcast) << (i & 63);
+    }
+  } else {
+    for (; i + LANES <= count; i += LANES) {
+      bitmap[i >> 6] |= CompareLanes<op>(Load(left + i), Load(right + i)) << (i & 63);
+    }
+  }
+#endif
+  for (; i < count; i++) {
+    uint64_t bit = CompareValues<op>(left[i], right == nullptr ? constant : right[i]);
+    bitmap[i >> 6] |= bit << (i & 63);
+  }
+}
+
+template <typename T>
+void CompareArrays(const T *left, const T *right, T constant, uint32_t count, CompareOp op, uint64_t *bitmap) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return CompareArrays<CompareOp::kEqual>(left, right, constant, count, bitmap);
+    case CompareOp::kNotEqual:
+      return CompareArrays<CompareOp::kNotEqual>(left, right, constant, count, bitmap);
+    case CompareOp::kLessThan:
+      return CompareArrays<CompareOp::kLessThan>(left, right, constant, count, bitmap);
+    case CompareOp::kLessThanEquals:
+      return CompareArrays<CompareOp::kLessThanEquals>(left, right, constant, count, bitmap);
+    case CompareOp::kGreaterThan:
+      return CompareArrays<CompareOp::kGreaterThan>(left, right, constant, count, bitmap);
+    case CompareOp::kGreaterThanEquals:
+      return CompareArrays<CompareOp::kGreaterThanEquals>(left, right, constant, count, bitmap);
+  }
+}
+
+/**
+ * @return memcmp style result of two prefixes
+ */
+inline int ComparePrefix(const char *left, const char *right) {
+  constexpr int size = FilterKernels::PREFIX_SIZE;
+#if defined(__SSE4_2__)
+  __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(left));
+  __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(right));
+  // index of the first byte which differs, size if there is none
+  int diff = _mm_cmpestri(a, size, b, size, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_EACH | _SIDD_NEGATIVE_POLARITY);
+  if (diff == size) {
+    return 0;
+  }
+  return static_cast<int>(static_cast<uint8_t>(left[diff])) - static_cast<int>(static_cast<uint8_t>(right[diff]));
+#else
+  return memcmp(left, right, size);
+#endif
+}
+
+template <CompareOp op>
+void ComparePrefixArrays(const char *left, const char *right, bool constant, uint32_t count, uint64_t *bitmap) {
+  memset(bitmap, 0, FilterKernels::GetBitmapSize(count) * sizeof(uint64_t));
+  for (uint32_t i = 0; i < count; i++) {
+    const char *other = constant ? right : right + i * FilterKernels::PREFIX_SIZE;
+    uint64_t bit = CompareResult<op>(ComparePrefix(left + i * FilterKernels::PREFIX_SIZE, other));
+    bitmap[i >> 6] |= bit << (i & 63);
+  }
+}
+
+void ComparePrefixArrays(const char *left, const char *right, bool constant, uint32_t count, CompareOp op,
+                         uint64_t *bitmap) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return ComparePrefixArrays<CompareOp::kEqual>(left, right, constant, count, bitmap);
+    case CompareOp::kNotEqual:
+      return ComparePrefixArrays<CompareOp::kNotEqual>(left, right, constant, count, bitmap);
+    case CompareOp::kLessThan:
+      return ComparePrefixArrays<CompareOp::kLessThan>(left, right, constant, count, bitmap);
+    case CompareOp::kLessThanEquals:
+      return ComparePrefixArrays<CompareOp::kLessThanEquals>(left, right, constant, count, bitmap);
+    case CompareOp::kGreaterThan:
+      return ComparePrefixArrays<CompareOp::kGreaterThan>(left, right, constant, count, bitmap);
+    case CompareOp::kGreaterThanEquals:
+      return ComparePrefixArrays<CompareOp::kGreaterThanEquals>(left, right, constant, count, bitmap);
+  }
+}
+
+}  // namespace
+
+void FilterKernels::Compare(const int32_t *values, uint32_t count, CompareOp op, int32_t constant,
+                            uint64_t *bitmap) {
+  CompareArrays<int32_t>(values, nullptr, constant, count, op, bitmap);
+}
+
+void FilterKernels::Compare(const int32_t *left, const int32_t *right, uint32_t count, CompareOp op,
+                            uint64_t *bitmap) {
+  CompareArrays<int32_t>(left, right, 0, count, op, bitmap);
+}
+
+void FilterKernels::Compare(const float *values, uint32_t count, CompareOp op, float constant, uint64_t *bitmap) {
+  CompareArrays<float>(values, nullptr, constant, count, op, bitmap);
+}
+
+void FilterKernels::Compare(const float *left, const float *right, uint32_t count, CompareOp op, uint64_t *bitmap) {
+  CompareArrays<float>(left, right, 0, count, op, bitmap);
+}
+
+void FilterKernels::ComparePrefixes(const char *prefixes, uint32_t count, CompareOp op, const char *constant,
+                                    uint64_t *bitmap) {
+  ComparePrefixArrays(prefixes, constant, true, count, op, bitmap);
+}
+
+void FilterKernels::ComparePrefixes(const char *left, const char *right, uint32_t count, CompareOp op,
+                                    uint64_t *bitmap) {
+  ComparePrefixArrays(left, right, false, count, op, bitmap);
+}
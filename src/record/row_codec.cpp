@@ -0,0 +1,120 @@
+#include "record/row_codec.h"
+
+#include "record/row.h"
+
+RowCodec::RowCodec(const std::vector<Column *> &columns, MemHeap *heap)
+    : num_columns_(static_cast<uint32_t>(columns.size())), null_bitmap_size_((num_columns_ + 7) / 8) {
+  // one block for all arrays, every element is 4 byte aligned
+  static_assert(alignof(Step) <= alignof(uint32_t) && sizeof(TypeId) % alignof(uint32_t) == 0,
+                "layout arrays share one block");
+  size_t size = num_columns_ * (sizeof(Step) + 2 * sizeof(uint32_t) + sizeof(TypeId));
+  char *block;
+  if (heap == nullptr) {
+    owned_ = std::make_unique<char[]>(size);
+    block = owned_.get();
+  } else {
+    block = static_cast<char *>(heap->Allocate(size));
+  }
+  steps_ = reinterpret_cast<Step *>(block);
+  field_offsets_ = reinterpret_cast<uint32_t *>(steps_ + num_columns_);
+  field_sizes_ = field_offsets_ + num_columns_;
+  field_types_ = reinterpret_cast<TypeId *>(field_sizes_ + num_columns_);
+  // fixed size values first, in column order, then one end offset per CHAR value
+  uint32_t offset = null_bitmap_size_;
+  for (uint32_t i = 0; i < num_columns_; i++) {
+    field_types_[i] = columns[i]->GetType();
+    field_sizes_[i] = 0;
+    if (field_types_[i] != TypeId::kTypeChar) {
+      field_offsets_[i] = offset;
+      field_sizes_[i] = Type::GetTypeSize(field_types_[i]);
+      steps_[num_fixed_steps_++] = Step{i, offset, field_types_[i]};
+      offset += field_sizes_[i];
+    }
+  }
+  var_table_offset_ = offset;
+  uint32_t num_steps = num_fixed_steps_;
+  for (uint32_t i = 0; i < num_columns_; i++) {
+    if (field_types_[i] == TypeId::kTypeChar) {
+      field_offsets_[i] = offset;
+      steps_[num_steps++] = Step{i, offset, TypeId::kTypeChar};
+      offset += sizeof(uint32_t);
+    }
+  }
+  fixed_size_ = offset;
+}
+
+uint32_t RowCodec::GetSerializedSize(const Row &row) const {
+  if (row.fields_.empty()) {
+    return 0;
+  }
+  uint32_t size = fixed_size_;
+  for (const Step *step = steps_ + num_fixed_steps_; step != steps_ + num_columns_; step++) {
+    const Field *field = row.fields_[step->column_];
+    if (!field->is_null_) {
+      size += field->len_;
+    }
+  }
+  return size;
+}
+
+uint32_t RowCodec::Encode(const Row &row, char *buf) const {
+  if (row.fields_.empty()) {
+    return 0;
+  }
+  ASSERT(row.fields_.size() == num_columns_, "Row does not match the schema.");
+  // null bits and the values of null fields stay zero
+  memset(buf, 0, fixed_size_);
+  for (const Step *step = steps_; step != steps_ + num_fixed_steps_; step++) {
+    const Field *field = row.fields_[step->column_];
+    if (field->is_null_) {
+      buf[step->column_ >> 3] |= static_cast<char>(1 << (step->column_ & 7));
+    } else if (step->type_ == TypeId::kTypeInt) {
+      MACH_WRITE_TO(int32_t, buf + step->offset_, field->value_.integer_);
+    } else {
+      MACH_WRITE_TO(float, buf + step->offset_, field->value_.float_);
+    }
+  }
+  uint32_t var_end = fixed_size_;
+  for (const Step *step = steps_ + num_fixed_steps_; step != steps_ + num_columns_; step++) {
+    const Field *field = row.fields_[step->column_];
+    if (field->is_null_) {
+      buf[step->column_ >> 3] |= static_cast<char>(1 << (step->column_ & 7));
+    } else {
+      memcpy(buf + var_end, field->GetChars(), field->len_);
+      var_end += field->len_;
+    }
+    MACH_WRITE_UINT32(buf + step->offset_, var_end);
+  }
+  return var_end;
+}
+
+uint32_t RowCodec::Decode(const char *buf, Row *row) const {
+  MemHeap *heap = row->heap_;
+  size_t first = row->fields_.size();
+  row->fields_.resize(first + num_columns_);
+  Field **fields = row->fields_.data() + first;
+  for (const Step *step = steps_; step != steps_ + num_fixed_steps_; step++) {
+    if (IsNull(buf, step->column_)) {
+      fields[step->column_] = ALLOC_P(heap, Field)(step->type_);
+    } else if (step->type_ == TypeId::kTypeInt) {
+      fields[step->column_] = ALLOC_P(heap, Field)(step->type_, MACH_READ_FROM(int32_t, buf + step->offset_));
+    } else {
+      fields[step->column_] = ALLOC_P(heap, Field)(step->type_, MACH_READ_FROM(float, buf + step->offset_));
+    }
+  }
+  uint32_t var_begin = fixed_size_;
+  for (const Step *step = steps_ + num_fixed_steps_; step != steps_ + num_columns_; step++) {
+    uint32_t var_end = MACH_READ_UINT32(buf + step->offset_);
+    if (IsNull(buf, step->column_)) {
+      fields[step->column_] = ALLOC_P(heap, Field)(TypeId::kTypeChar);
+    } else {
+      // the chars are copied into the heap too, so the field is released with it
+      uint32_t len = var_end - var_begin;
+      char *chars = static_cast<char *>(heap->Allocate(len));
+      memcpy(chars, buf + var_begin, len);
+      fields[step->column_] = ALLOC_P(heap, Field)(TypeId::kTypeChar, chars, len, false);
+    }
+    var_begin = var_end;
+  }
+  return var_begin;
+}
@@ -0,0 +1,29 @@
+#include "record/row_view.h"
+
+Field RowView::GetField(uint32_t idx) const {
+  TypeId type = schema_->GetColumn(idx)->GetType();
+  if (IsNull(idx)) {
+    return Field(type);
+  }
+  switch (type) {
+    case TypeId::kTypeInt:
+      return Field(type, GetInt(idx));
+    case TypeId::kTypeFloat:
+      return Field(type, GetFloat(idx));
+    case TypeId::kTypeChar: {
+      uint32_t len;
+      const char *chars = GetChars(idx, &len);
+      return Field(type, const_cast<char *>(chars), len, false);
+    }
+    default:
+      ASSERT(false, "Unsupported field type.");
+      return Field(type);
+  }
+}
+
+void RowView::ToRow(Row *row) const {
+  ASSERT(row->GetFieldCount() == 0, "Row already has fields.");
+  row->SetRowId(rid_);
+  uint32_t __attribute__((unused)) read_bytes = row->DeserializeFrom(const_cast<char *>(data_), schema_);
+  ASSERT(read_bytes == size_, "Unexpected behavior in tuple deserialize.");
+}
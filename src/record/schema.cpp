@@ -75,6 +75,6 @@ uint32_t Schema::DeserializeFrom(char *buf, Schema *&schema, MemHeap *heap) {
     columns.push_back(col);
   }
   void *mem = heap->Allocate(sizeof(Schema));
-  schema = new (mem) Schema(columns);
+  schema = new (mem) Schema(columns, heap);
   return ofs; 
 }
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "storage/async_io_engine.h"
+
+AsyncIOEngine::AsyncIOEngine(size_t num_threads) {
+  ASSERT(num_threads > 0, "Async I/O engine needs at least one worker.");
+  workers_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; i++) {
+    workers_.emplace_back(&AsyncIOEngine::WorkerLoop, this);
+  }
+}
+
+AsyncIOEngine::~AsyncIOEngine() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void AsyncIOEngine::Submit(std::function<void()> request) {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    ASSERT(!stop_, "Submit to a stopped async I/O engine.");
+    requests_.push(std::move(request));
+  }
+  cv_.notify_one();
+}
+
+void AsyncIOEngine::WorkerLoop() {
+  while (true) {
+    std::function<void()> request;
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      cv_.wait(lock, [this] { return stop_ || !requests_.empty(); });
+      // pending requests are still served after stop_, nobody must be left waiting on a future
+      if (requests_.empty()) {
+        return;
+      }
+      request = std::move(requests_.front());
+      requests_.pop();
+    }
+    request();
+  }
+}
@@ -1,143 +1,441 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <fcntl.h>
 #include <stdexcept>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 #include "storage/disk_manager.h"
 
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, bool direct_io) : file_name_(db_file) {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-    if (!db_io_.is_open()) {
-      throw std::exception();
+  SegmentFile &file = segments_[0];
+  // segment 0 is opened here, the once flag only guards the other segments
+  std::call_once(file.open_, []() {});
+#ifdef O_DIRECT
+  if (direct_io) {
+    file.fd_ = open(db_file.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0644);
+    if (file.fd_ >= 0) {
+      direct_io_ = true;
+    } else {
+      LOG(WARNING) << "O_DIRECT is not supported for " << db_file << ", fall back to buffered I/O";
     }
   }
-  ReadPhysicalPage(META_PAGE_ID, meta_data_);
+#endif
+  // create the file if it does not exist
+  if (file.fd_ < 0) {
+    file.fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  }
+  if (file.fd_ < 0) {
+    throw std::exception();
+  }
+  file.file_size_ = GetFileSize(file.fd_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(GetSegmentMeta(0));
+  // pages of an older format would be silently misread
+  if (file.file_size_ == 0) {
+    meta_page->format_version_ = DiskFileMetaPage::FORMAT_VERSION;
+    meta_page->num_segments_ = 1;
+  } else if (meta_page->format_version_ != DiskFileMetaPage::FORMAT_VERSION) {
+    close(file.fd_);
+    file.fd_ = -1;
+    throw std::runtime_error(db_file + " has format version " + std::to_string(meta_page->format_version_)
+                             + ", expected " + std::to_string(DiskFileMetaPage::FORMAT_VERSION));
+  }
 }
 
 void DiskManager::Close() {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   if (!closed) {
-    db_io_.close();
+    // drain the outstanding asynchronous requests before the file descriptor goes away
+    StopIOEngines();
+    if (!WriteBackMetaData()) {
+      LOG(ERROR) << "Failed to write back the meta data of " << file_name_;
+    }
+    for (auto &file : segments_) {
+      if (file.fd_ >= 0) {
+        close(file.fd_);
+        file.fd_ = -1;
+      }
+    }
     closed = true;
   }
 }
 
-void DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
+bool DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  return ReadPhysicalPage(MapPageId(logical_page_id), page_data);
+}
+
+bool DiskManager::WritePage(page_id_t logical_page_id, const char *page_data) {
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  return WritePhysicalPage(MapPageId(logical_page_id), page_data);
+}
+
+std::future<bool> DiskManager::ReadPageAsync(page_id_t logical_page_id, char *page_data) {
   ASSERT(logical_page_id >= 0, "Invalid page id.");
-  ReadPhysicalPage(MapPageId(logical_page_id), page_data);
+  auto done = std::make_shared<std::promise<bool>>();
+  std::future<bool> future = done->get_future();
+  ReadPageAsync(logical_page_id, page_data, [done](bool read) { done->set_value(read); });
+  return future;
 }
 
-void DiskManager::WritePage(page_id_t logical_page_id, const char *page_data) {
+void DiskManager::ReadPageAsync(page_id_t logical_page_id, char *page_data, std::function<void(bool)> callback) {
   ASSERT(logical_page_id >= 0, "Invalid page id.");
-  WritePhysicalPage(MapPageId(logical_page_id), page_data);
-}
-
-page_id_t DiskManager::AllocatePage() {
-  size_t PageNum = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
-  DiskFileMetaPage *MetaData = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
-  uint32_t extent_num = MetaData->num_extents_;
-  uint32_t extent_id = 0;
-  bool flag = false;
-  for (; extent_id < extent_num; extent_id++) {
-    if (MetaData->extent_used_page_[extent_id] != PageNum) {
-      flag = true;
-      break;
+  physical_page_id_t physical_page_id = MapPageId(logical_page_id);
+  GetReadEngine()->Submit([this, physical_page_id, page_data, callback = std::move(callback)]() {
+    callback(ReadPhysicalPage(physical_page_id, page_data));
+  });
+}
+
+std::future<std::vector<bool>> DiskManager::WritePagesAsync(std::vector<std::pair<page_id_t, const char *>> pages) {
+  struct BatchState {
+    std::atomic<size_t> remaining_;
+    std::vector<uint8_t> written_;  // one byte per page, the workers set them concurrently
+    std::promise<std::vector<bool>> done_;
+  };
+  auto state = std::make_shared<BatchState>();
+  std::future<std::vector<bool>> future = state->done_.get_future();
+  if (pages.empty()) {
+    state->done_.set_value({});
+    return future;
+  }
+  state->remaining_ = pages.size();
+  state->written_.resize(pages.size(), false);
+  // submit in physical order, so the requests picked up first by the workers are adjacent on disk
+  std::vector<size_t> order(pages.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&pages](size_t a, size_t b) { return pages[a].first < pages[b].first; });
+  AsyncIOEngine *engine = GetWriteEngine();
+  for (auto i : order) {
+    ASSERT(pages[i].first >= 0, "Invalid page id.");
+    physical_page_id_t physical_page_id = MapPageId(pages[i].first);
+    const char *page_data = pages[i].second;
+    engine->Submit([this, physical_page_id, page_data, state, i]() {
+      state->written_[i] = WritePhysicalPage(physical_page_id, page_data);
+      if (--state->remaining_ == 0) {
+        state->done_.set_value(std::vector<bool>(state->written_.begin(), state->written_.end()));
+      }
+    });
+  }
+  return future;
+}
+
+AsyncIOEngine *DiskManager::GetReadEngine() {
+  std::call_once(read_engine_init_, [this]() { read_engine_ = std::make_unique<AsyncIOEngine>(); });
+  ASSERT(read_engine_ != nullptr, "Async I/O after the disk manager is closed.");
+  return read_engine_.get();
+}
+
+AsyncIOEngine *DiskManager::GetWriteEngine() {
+  std::call_once(write_engine_init_, [this]() { write_engine_ = std::make_unique<AsyncIOEngine>(); });
+  ASSERT(write_engine_ != nullptr, "Async I/O after the disk manager is closed.");
+  return write_engine_.get();
+}
+
+void DiskManager::StopIOEngines() {
+  // read callbacks may still issue writes
+  read_engine_.reset();
+  write_engine_.reset();
+}
+
+page_id_t DiskManager::AllocatePage(extent_owner_t owner_id) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (owner_id == INVALID_EXTENT_OWNER) {
+    return AllocateUnreserved();
+  }
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(GetSegmentMeta(0));
+  ExtentReservation &reservation = meta_page->GetReservationSlot(owner_id);
+  page_id_t page_id;
+  if (reservation.owner_id_ == owner_id && AllocateInRun(reservation.first_page_id_, page_id)) {
+    return page_id;
+  }
+  page_id_t first_page_id;
+  if (!FindFreeRun(first_page_id)) {
+    // too fragmented for another run, the owner's pages just won't be contiguous
+    return AllocateUnreserved();
+  }
+  reservation.owner_id_ = owner_id;
+  reservation.first_page_id_ = first_page_id;
+  bool allocated = AllocateInRun(first_page_id, page_id);
+  ASSERT(allocated, "A free run has no free page.");
+  return page_id;
+}
+
+page_id_t DiskManager::AllocateUnreserved() {
+  uint32_t num_extents = GetNumExtents();
+  while (first_free_extent_ < num_extents && ExtentUsedPages(first_free_extent_) == BITMAP_SIZE) {
+    first_free_extent_++;
+  }
+  for (uint32_t extent_id = first_free_extent_; EnsureExtent(extent_id); extent_id++) {
+    if (ExtentUsedPages(extent_id) == BITMAP_SIZE) {
+      continue;
+    }
+    BitmapPage<PAGE_SIZE> *bitmap = GetBitmap(extent_id);
+    uint32_t page_offset = 0;
+    while (bitmap->FindFreePage(page_offset, page_offset)) {
+      page_id_t run = GetReservedRun(BITMAP_SIZE * extent_id + page_offset);
+      if (run == INVALID_PAGE_ID) {
+        MarkAllocated(extent_id, page_offset);
+        return BITMAP_SIZE * extent_id + page_offset;
+      }
+      // the rest of the run belongs to its owner
+      page_offset = run - BITMAP_SIZE * extent_id + BitmapPage<PAGE_SIZE>::RUN_SIZE;
     }
   }
-  MetaData->num_allocated_pages_++;
+  LOG(ERROR) << "Database file is full";
+  return INVALID_PAGE_ID;
+}
+
+bool DiskManager::AllocateInRun(page_id_t first_page_id, page_id_t &page_id) {
+  uint32_t extent_id = first_page_id / BITMAP_SIZE;
+  uint32_t run_offset = first_page_id % BITMAP_SIZE;
   uint32_t page_offset;
-  if (flag) {
-    char NowBitMap[PAGE_SIZE];
-    ReadPhysicalPage((PageNum + 1) * extent_id + 1, NowBitMap);
-    (reinterpret_cast<BitmapPage<PAGE_SIZE> *>(NowBitMap))->AllocatePage(page_offset);
-    MetaData->extent_used_page_[extent_id]++;
-    WritePhysicalPage((PageNum + 1) * extent_id + 1, NowBitMap);
-  } else {
-    MetaData->num_extents_++;
-    MetaData->extent_used_page_[extent_id] = 1;
-    BitmapPage<PAGE_SIZE> *NewBitMap = new BitmapPage<PAGE_SIZE>;
-    NewBitMap->AllocatePage(page_offset);
-    WritePhysicalPage((PageNum + 1) * extent_id + 1, reinterpret_cast<char *>(NewBitMap));
-  }
-  return page_offset + PageNum * extent_id;
+  if (!GetBitmap(extent_id)->FindFreePage(run_offset, page_offset)
+      || page_offset >= run_offset + BitmapPage<PAGE_SIZE>::RUN_SIZE) {
+    return false;
+  }
+  MarkAllocated(extent_id, page_offset);
+  page_id = BITMAP_SIZE * extent_id + page_offset;
+  return true;
+}
+
+bool DiskManager::FindFreeRun(page_id_t &first_page_id) {
+  for (uint32_t extent_id = first_free_extent_; EnsureExtent(extent_id); extent_id++) {
+    BitmapPage<PAGE_SIZE> *bitmap = GetBitmap(extent_id);
+    uint32_t run_offset = 0;
+    while (bitmap->FindFreeRun(run_offset, run_offset)) {
+      first_page_id = BITMAP_SIZE * extent_id + run_offset;
+      if (GetReservedRun(first_page_id) == INVALID_PAGE_ID) {
+        return true;
+      }
+      run_offset += BitmapPage<PAGE_SIZE>::RUN_SIZE;
+    }
+  }
+  return false;
+}
+
+page_id_t DiskManager::GetReservedRun(page_id_t page_id) {
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(GetSegmentMeta(0));
+  for (auto &reservation : meta_page->reservations_) {
+    if (reservation.owner_id_ != INVALID_EXTENT_OWNER && reservation.first_page_id_ <= page_id
+        && page_id < reservation.first_page_id_ + static_cast<page_id_t>(BitmapPage<PAGE_SIZE>::RUN_SIZE)) {
+      return reservation.first_page_id_;
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+bool DiskManager::EnsureExtent(uint32_t extent_id) {
+  uint32_t num_extents = GetNumExtents();
+  if (extent_id < num_extents) {
+    return true;
+  }
+  if (extent_id > num_extents || extent_id >= DiskFileMetaPage::MAX_SEGMENTS * EXTENTS_PER_SEGMENT) {
+    return false;
+  }
+  auto *root_meta_page = reinterpret_cast<DiskFileMetaPage *>(GetSegmentMeta(0));
+  if (extent_id / EXTENTS_PER_SEGMENT == root_meta_page->num_segments_) {
+    // the last segment is full, its successor file is created by the first access to it
+    root_meta_page->num_segments_++;
+  }
+  DiskFileMetaPage *meta_page = GetExtentMeta(extent_id);
+  meta_page->num_extents_++;
+  meta_page->extent_used_page_[extent_id % EXTENTS_PER_SEGMENT] = 0;
+  return true;
+}
+
+uint32_t DiskManager::GetNumExtents() {
+  uint32_t last_segment = GetNumSegments() - 1;
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(GetSegmentMeta(last_segment));
+  return last_segment * EXTENTS_PER_SEGMENT + meta_page->num_extents_;
+}
+
+uint32_t DiskManager::GetNumSegments() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  return reinterpret_cast<DiskFileMetaPage *>(GetSegmentMeta(0))->num_segments_;
+}
+
+void DiskManager::MarkAllocated(uint32_t extent_id, uint32_t page_offset) {
+  bool allocated = GetBitmap(extent_id)->MarkAllocated(page_offset);
+  ASSERT(allocated, "Page is already allocated.");
+  bitmap_dirty_[extent_id] = true;
+  ExtentUsedPages(extent_id)++;
+  GetExtentMeta(extent_id)->num_allocated_pages_++;
 }
 
 void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
-  size_t PageNum = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
-  uint32_t extent_id = logical_page_id / PageNum;
-  uint32_t page_offset = logical_page_id % PageNum;
-  char NowBitMap[PAGE_SIZE];
-  ReadPhysicalPage((PageNum + 1) * extent_id + 1, NowBitMap);
-  if ((reinterpret_cast<BitmapPage<PAGE_SIZE> *>(NowBitMap))->DeAllocatePage(page_offset) == false) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  uint32_t extent_id = logical_page_id / BITMAP_SIZE;
+  uint32_t page_offset = logical_page_id % BITMAP_SIZE;
+  if (extent_id >= GetNumExtents() || !GetBitmap(extent_id)->DeAllocatePage(page_offset)) {
     return;
   }
-  WritePhysicalPage((PageNum + 1) * extent_id + 1, NowBitMap);
-  DiskFileMetaPage *MetaData = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
-  MetaData->num_allocated_pages_--;
-  MetaData->extent_used_page_[extent_id]--;
+  bitmap_dirty_[extent_id] = true;
+  GetExtentMeta(extent_id)->num_allocated_pages_--;
+  ExtentUsedPages(extent_id)--;
+  first_free_extent_ = std::min(first_free_extent_, extent_id);
 }
 
 bool DiskManager::IsPageFree(page_id_t logical_page_id) {
-  size_t PageNum = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
-  uint32_t extent_id = logical_page_id / PageNum;
-  char NotBitMap[PAGE_SIZE];
-  ReadPhysicalPage((PageNum + 1) * extent_id + 1, NotBitMap); 
-  return (reinterpret_cast<BitmapPage<PAGE_SIZE> *>(NotBitMap)->IsPageFree(logical_page_id % PageNum));
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  uint32_t extent_id = logical_page_id / BITMAP_SIZE;
+  if (extent_id >= GetNumExtents()) {
+    return true;
+  }
+  return GetBitmap(extent_id)->IsPageFree(logical_page_id % BITMAP_SIZE);
 }
 
-page_id_t DiskManager::MapPageId(page_id_t logical_page_id) {
-  size_t PageNum = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
-  return logical_page_id + logical_page_id / PageNum + 2;
+BitmapPage<PAGE_SIZE> *DiskManager::GetBitmap(uint32_t extent_id) {
+  if (extent_id >= bitmaps_.size()) {
+    bitmaps_.resize(extent_id + 1);
+    bitmap_dirty_.resize(extent_id + 1, false);
+  }
+  if (bitmaps_[extent_id] == nullptr) {
+    bitmaps_[extent_id] = std::make_unique<BitmapPage<PAGE_SIZE>>();
+    // a new extent has no bitmap on disk yet, reading it gives an empty one
+    if (!ReadPhysicalPage(MapBitmapId(extent_id), reinterpret_cast<char *>(bitmaps_[extent_id].get()))) {
+      throw std::runtime_error("failed to read bitmap page of extent " + std::to_string(extent_id));
+    }
+  }
+  return bitmaps_[extent_id].get();
+}
+
+char *DiskManager::GetSegmentMeta(uint32_t segment_id) {
+  if (segment_id >= meta_data_.size()) {
+    meta_data_.resize(segment_id + 1);
+  }
+  if (meta_data_[segment_id] == nullptr) {
+    meta_data_[segment_id] = std::make_unique<char[]>(PAGE_SIZE);
+    if (!ReadPhysicalPage(PHYSICAL_PAGES_PER_SEGMENT * segment_id + META_PAGE_ID, meta_data_[segment_id].get())) {
+      throw std::runtime_error("failed to read meta page of segment " + std::to_string(segment_id));
+    }
+  }
+  return meta_data_[segment_id].get();
 }
 
-int DiskManager::GetFileSize(const std::string &file_name) {
+bool DiskManager::WriteBackMetaData() {
+  bool success = true;
+  for (size_t extent_id = 0; extent_id < bitmaps_.size(); extent_id++) {
+    if (bitmap_dirty_[extent_id]) {
+      bool written = WritePhysicalPage(MapBitmapId(extent_id), reinterpret_cast<char *>(bitmaps_[extent_id].get()));
+      bitmap_dirty_[extent_id] = !written;
+      success = success && written;
+    }
+  }
+  for (size_t segment_id = 0; segment_id < meta_data_.size(); segment_id++) {
+    if (meta_data_[segment_id] != nullptr) {
+      success = WritePhysicalPage(PHYSICAL_PAGES_PER_SEGMENT * segment_id + META_PAGE_ID, meta_data_[segment_id].get())
+                && success;
+    }
+  }
+  return success;
+}
+
+physical_page_id_t DiskManager::MapPageId(page_id_t logical_page_id) {
+  uint32_t segment_id = logical_page_id / PAGES_PER_SEGMENT;
+  page_id_t segment_page_id = logical_page_id % PAGES_PER_SEGMENT;
+  return PHYSICAL_PAGES_PER_SEGMENT * segment_id + segment_page_id + segment_page_id / BITMAP_SIZE + 2;
+}
+
+physical_page_id_t DiskManager::MapBitmapId(uint32_t extent_id) {
+  uint32_t segment_id = extent_id / EXTENTS_PER_SEGMENT;
+  uint32_t segment_extent_id = extent_id % EXTENTS_PER_SEGMENT;
+  return PHYSICAL_PAGES_PER_SEGMENT * segment_id + (BITMAP_SIZE + 1) * segment_extent_id + 1;
+}
+
+off_t DiskManager::GetFileSize(int fd) {
   struct stat stat_buf;
-  int rc = stat(file_name.c_str(), &stat_buf);
+  int rc = fstat(fd, &stat_buf);
   return rc == 0 ? stat_buf.st_size : -1;
 }
 
-void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data) {
-  int offset = physical_page_id * PAGE_SIZE;
+DiskManager::SegmentFile &DiskManager::GetSegmentFile(uint32_t segment_id) {
+  ASSERT(segment_id < DiskFileMetaPage::MAX_SEGMENTS, "Invalid page id.");
+  SegmentFile &file = segments_[segment_id];
+  std::call_once(file.open_, [this, segment_id, &file]() {
+    std::string segment_name = file_name_ + "." + std::to_string(segment_id);
+    int flags = O_RDWR | O_CREAT;
+#ifdef O_DIRECT
+    if (direct_io_) {
+      flags |= O_DIRECT;
+    }
+#endif
+    file.fd_ = open(segment_name.c_str(), flags, 0644);
+    if (file.fd_ < 0) {
+      LOG(ERROR) << "Failed to open segment file " << segment_name;
+      return;
+    }
+    file.file_size_ = GetFileSize(file.fd_);
+  });
+  return file;
+}
+
+/**
+ * O_DIRECT requires aligned buffers. Frames are aligned already, other callers (e.g. bitmap pages on the stack)
+ * go through a per thread bounce buffer.
+ */
+static char *GetBounceBuffer() {
+  alignas(DIRECT_IO_ALIGNMENT) static thread_local char buffer[PAGE_SIZE];
+  return buffer;
+}
+
+static bool IsAligned(const char *data) {
+  return reinterpret_cast<uintptr_t>(data) % DIRECT_IO_ALIGNMENT == 0;
+}
+
+bool DiskManager::ReadPhysicalPage(physical_page_id_t physical_page_id, char *page_data) {
+  SegmentFile &file = GetSegmentFile(physical_page_id / PHYSICAL_PAGES_PER_SEGMENT);
+  off_t offset = physical_page_id % PHYSICAL_PAGES_PER_SEGMENT * PAGE_SIZE;
   // check if read beyond file length
-  if (offset >= GetFileSize(file_name_)) {
+  if (offset >= file.file_size_) {
 #ifdef ENABLE_BPM_DEBUG
     LOG(INFO) << "Read less than a page" << std::endl;
 #endif
     memset(page_data, 0, PAGE_SIZE);
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
+    return true;
+  }
+  char *buffer = (direct_io_ && !IsAligned(page_data)) ? GetBounceBuffer() : page_data;
+  ssize_t read_count = pread(file.fd_, buffer, PAGE_SIZE, offset);
+  // an I/O error must not be mistaken for the end of the file, the caller would use a zeroed page
+  if (read_count < 0) {
+    LOG(ERROR) << "I/O error while reading: " << strerror(errno);
+    return false;
+  }
+  if (buffer != page_data) {
+    memcpy(page_data, buffer, read_count);
+  }
+  // if file ends before reading PAGE_SIZE
+  if (read_count < PAGE_SIZE) {
 #ifdef ENABLE_BPM_DEBUG
-      LOG(INFO) << "Read less than a page" << std::endl;
+    LOG(INFO) << "Read less than a page" << std::endl;
 #endif
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
-    }
+    memset(page_data + read_count, 0, PAGE_SIZE - read_count);
   }
+  return true;
 }
 
-void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
-  // set write cursor to offset
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
-    LOG(ERROR) << "I/O error while writing";
-    return;
+bool DiskManager::WritePhysicalPage(physical_page_id_t physical_page_id, const char *page_data) {
+  SegmentFile &file = GetSegmentFile(physical_page_id / PHYSICAL_PAGES_PER_SEGMENT);
+  off_t offset = physical_page_id % PHYSICAL_PAGES_PER_SEGMENT * PAGE_SIZE;
+  const char *buffer = page_data;
+  if (direct_io_ && !IsAligned(page_data)) {
+    char *bounce = GetBounceBuffer();
+    memcpy(bounce, page_data, PAGE_SIZE);
+    buffer = bounce;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
-}
\ No newline at end of file
+  // a short write leaves part of the old page on disk, it fails like an I/O error
+  ssize_t write_count = pwrite(file.fd_, buffer, PAGE_SIZE, offset);
+  if (write_count != PAGE_SIZE) {
+    LOG(ERROR) << "I/O error while writing: " << (write_count < 0 ? strerror(errno) : "short write");
+    return false;
+  }
+  off_t end = offset + PAGE_SIZE;
+  off_t size = file.file_size_.load();
+  while (size < end && !file.file_size_.compare_exchange_weak(size, end)) {}
+  return true;
+}
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "glog/logging.h"
+#include "storage/mmap_disk_manager.h"
+
+MmapDiskManager::MmapDiskManager(const std::string &db_file) : DiskManager(db_file) {
+  // reserve address space only, the file is mapped into it piece by piece
+  void *mapping = mmap(nullptr, MAX_MAPPED_SIZE, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (mapping == MAP_FAILED) {
+    throw std::runtime_error("failed to reserve address space for " + db_file);
+  }
+  mapping_ = static_cast<char *>(mapping);
+  size_t file_size = static_cast<size_t>(segments_[0].file_size_) / PAGE_SIZE * PAGE_SIZE;
+  if (file_size > 0 && !Grow(file_size)) {
+    munmap(mapping_, MAX_MAPPED_SIZE);
+    throw std::runtime_error("failed to map " + db_file);
+  }
+}
+
+void MmapDiskManager::Close() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (!closed) {
+    // asynchronous requests and the meta data write back still go through the mapping
+    StopIOEngines();
+    if (!WriteBackMetaData()) {
+      LOG(ERROR) << "Failed to write back the meta data of " << file_name_;
+    }
+    munmap(mapping_, MAX_MAPPED_SIZE);
+    mapping_ = nullptr;
+    mapped_size_ = 0;
+    for (auto &file : segments_) {
+      if (file.fd_ >= 0) {
+        close(file.fd_);
+        file.fd_ = -1;
+      }
+    }
+    closed = true;
+  }
+}
+
+bool MmapDiskManager::Grow(size_t size) {
+  std::scoped_lock<std::mutex> lock(grow_latch_);
+  size_t mapped_size = mapped_size_;
+  if (size <= mapped_size) {
+    return true;
+  }
+  if (size > MAX_MAPPED_SIZE) {
+    LOG(ERROR) << "Database file exceeds " << MAX_MAPPED_SIZE << " bytes";
+    return false;
+  }
+  // grow geometrically so that appending pages does not remap for every extent
+  size_t new_size = std::min(std::max({size, 2 * mapped_size, MIN_GROW_SIZE}), MAX_MAPPED_SIZE);
+  SegmentFile &file = segments_[0];
+  if (static_cast<off_t>(new_size) > file.file_size_ && ftruncate(file.fd_, new_size) != 0) {
+    LOG(ERROR) << "I/O error while extending file";
+    return false;
+  }
+  file.file_size_ = std::max<off_t>(file.file_size_, new_size);
+  void *mapping = mmap(mapping_ + mapped_size, new_size - mapped_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_FIXED, file.fd_, mapped_size);
+  if (mapping == MAP_FAILED) {
+    LOG(ERROR) << "Failed to map database file";
+    return false;
+  }
+  mapped_size_ = new_size;
+  return true;
+}
+
+bool MmapDiskManager::ReadPhysicalPage(physical_page_id_t physical_page_id, char *page_data) {
+  if (physical_page_id >= PHYSICAL_PAGES_PER_SEGMENT) {
+    return DiskManager::ReadPhysicalPage(physical_page_id, page_data);
+  }
+  size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
+  // check if read beyond file length
+  if (offset + PAGE_SIZE > mapped_size_) {
+    memset(page_data, 0, PAGE_SIZE);
+    return true;
+  }
+  memcpy(page_data, mapping_ + offset, PAGE_SIZE);
+  return true;
+}
+
+bool MmapDiskManager::WritePhysicalPage(physical_page_id_t physical_page_id, const char *page_data) {
+  if (physical_page_id >= PHYSICAL_PAGES_PER_SEGMENT) {
+    return DiskManager::WritePhysicalPage(physical_page_id, page_data);
+  }
+  size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
+  if (offset + PAGE_SIZE > mapped_size_ && !Grow(offset + PAGE_SIZE)) {
+    LOG(ERROR) << "I/O error while writing";
+    return false;
+  }
+  memcpy(mapping_ + offset, page_data, PAGE_SIZE);
+  return true;
+}
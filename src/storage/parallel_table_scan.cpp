@@ -0,0 +1,73 @@
+#include <algorithm>
+
+#include "storage/parallel_table_scan.h"
+
+ParallelTableScan::ParallelTableScan(TableHeap *table_heap, size_t num_workers, size_t morsel_size)
+    : table_heap_(table_heap), num_workers_(num_workers), morsel_size_(std::max<size_t>(morsel_size, 1)) {
+  if (num_workers_ == 0) {
+    num_workers_ = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  }
+}
+
+bool ParallelTableScan::Execute(const std::function<void(size_t worker_id, ColumnBatch &batch)> &process,
+                                Transaction *txn) {
+  std::vector<page_id_t> page_ids;
+  if (!table_heap_->GetPageIds(&page_ids)) {
+    return false;
+  }
+  // index of the first page of the next morsel
+  std::atomic<size_t> next_page{0};
+  size_t num_morsels = (page_ids.size() + morsel_size_ - 1) / morsel_size_;
+  size_t num_workers = std::min(num_workers_, num_morsels);
+  std::atomic<bool> success{true};
+  std::vector<std::thread> workers;
+  workers.reserve(num_workers);
+  for (size_t worker_id = 0; worker_id < num_workers; worker_id++) {
+    workers.emplace_back([&, worker_id]() {
+      if (!Work(worker_id, page_ids, next_page, process)) {
+        success = false;
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  return success;
+}
+
+bool ParallelTableScan::Work(size_t worker_id, const std::vector<page_id_t> &page_ids,
+                             std::atomic<size_t> &next_page,
+                             const std::function<void(size_t worker_id, ColumnBatch &batch)> &process) {
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  ColumnBatch batch(table_heap_->schema_);
+  // every worker recycles its own ring of frames
+  auto strategy = std::make_shared<BufferAccessStrategy>();
+  size_t begin;
+  while ((begin = next_page.fetch_add(morsel_size_)) < page_ids.size()) {
+    size_t end = std::min(begin + morsel_size_, page_ids.size());
+    // the pages of a morsel are consecutive in the chain
+    buffer_pool_manager->PrefetchChain(page_ids[begin], TablePage::GetNextPageId, end - begin, strategy);
+    for (size_t i = begin; i < end; i++) {
+      auto page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(page_ids[i], strategy.get()));
+      if (page == nullptr) {
+        // no more morsels are handed out, the other workers stop after their current one
+        next_page = page_ids.size();
+        return false;
+      }
+      page->RLatch();
+      uint32_t slot_num = 0;
+      while ((slot_num = page->DecodeTuples(slot_num, &batch)) < page->GetTupleCount()) {
+        // the batch is full
+        process(worker_id, batch);
+        batch.Reset();
+      }
+      page->RUnlatch();
+      buffer_pool_manager->UnpinPage(page_ids[i], false);
+    }
+    if (batch.GetSize() > 0) {
+      process(worker_id, batch);
+      batch.Reset();
+    }
+  }
+  return true;
+}
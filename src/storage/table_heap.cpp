@@ -2,50 +2,325 @@
 
 bool TableHeap::InsertTuple(Row &row, Transaction *txn) {
   uint32_t serialized_size = row.GetSerializedSize(schema_);
-  if (serialized_size + 32 > PAGE_SIZE) {
+  if (serialized_size > TablePage::SIZE_MAX_ROW) {
     return false;
   }
+  uint8_t required_bucket = FreeSpaceMapPage::ToRequiredBucket(serialized_size + TablePage::SIZE_TUPLE);
 
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-  if (cur_page == nullptr) {
-    return false;
-  }
-  cur_page->WLatch();
-  // Insert into the first page with enough space. If no such page exists, create a new page and insert into that.
-  // INVARIANT: cur_page is WLatched if you leave the loop normally.
-  while (!cur_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_)) {
-    auto next_page_id = cur_page->GetNextPageId();
-    // If the next page is a valid page,
-    if (next_page_id != INVALID_PAGE_ID) {
-      // Unlatch and unpin the current page.
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
-      // And repeat the process with the next page.
-      cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
-      cur_page->WLatch();
-    } else {
-      // Otherwise we have run out of valid pages. We need to create a new page.
-      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(next_page_id));
-      // If we could not create a new page,
-      if (new_page == nullptr) {
-        // Then life sucks and we abort the transaction.
-        cur_page->WUnlatch();
-        buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
-        return false;
+  // The root is only latched to pick a leaf. The leaf latch covers the leaf's entries and is taken before a table
+  // page, so inserts into pages of different leaves do not wait for each other.
+  while (true) {
+    auto root_page = buffer_pool_manager_->FetchPage(fsm_root_page_id_);
+    if (root_page == nullptr) {
+      return false;
+    }
+    root_page->RLatch();
+    auto root = reinterpret_cast<FreeSpaceMapPage *>(root_page->GetData());
+    int leaf_slot = root->FindSlot(required_bucket);
+    page_id_t leaf_page_id = leaf_slot == -1 ? INVALID_PAGE_ID : root->GetEntryPageId(leaf_slot);
+    root_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(fsm_root_page_id_, false);
+    if (leaf_page_id == INVALID_PAGE_ID) {
+      return InsertIntoTail(row, txn);
+    }
+    auto leaf_page = buffer_pool_manager_->FetchPage(leaf_page_id);
+    if (leaf_page == nullptr) {
+      return false;
+    }
+    leaf_page->WLatch();
+    auto leaf = reinterpret_cast<FreeSpaceMapPage *>(leaf_page->GetData());
+    uint8_t max_bucket = leaf->GetMaxBucket();
+    bool inserted = false;
+    int slot = -1;
+    while (!inserted && (slot = leaf->FindSlot(required_bucket)) != -1) {
+      auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(leaf->GetEntryPageId(slot)));
+      if (cur_page == nullptr) {
+        break;
       }
-      // Otherwise we were able to create a new page. We initialize it now.
-      new_page->WLatch();
-      cur_page->SetNextPageId(next_page_id);
-      new_page->Init(next_page_id, cur_page->GetTablePageId(), log_manager_, txn);
+      cur_page->WLatch();
+      // only fails if the bucket is stale, the corrected bucket keeps the page from being picked again
+      inserted = cur_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+      leaf->SetBucket(slot, FreeSpaceMapPage::ToBucket(cur_page->GetFreeSpaceRemaining()));
       cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
-      cur_page = new_page;
+      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), inserted);
     }
+    bool grown = leaf->GetMaxBucket() > max_bucket;
+    leaf_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf_page_id, true);
+    // The root entry may stay too large after an insert, it is corrected once a leaf turns out to have no room,
+    // so the next round picks another leaf.
+    if ((grown || !inserted) && !RefreshLeafBucket(leaf_page_id)) {
+      return inserted;
+    }
+    if (inserted || slot != -1) {
+      // slot != -1 means out of frames
+      return inserted;
+    }
+  }
+}
+
+bool TableHeap::InsertTuples(std::vector<Row> &rows, Transaction *txn) {
+  for (auto &row : rows) {
+    if (row.GetSerializedSize(schema_) > TablePage::SIZE_MAX_ROW) {
+      return false;
+    }
+  }
+  if (rows.empty()) {
+    return true;
   }
-  cur_page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
+  // the root stays pinned for the whole batch, it is only latched to append a page
+  auto root_page = buffer_pool_manager_->FetchPage(fsm_root_page_id_);
+  if (root_page == nullptr) {
+    return false;
+  }
+  auto cur_page = LatchTailPage(root_page);
+  // The tail page stays latched until it is full, a page is fetched once for all the rows it takes.
+  bool inserted = cur_page != nullptr;
+  for (size_t i = 0; inserted && i < rows.size(); i++) {
+    if (cur_page->InsertTuple(rows[i], schema_, txn, lock_manager_, log_manager_)) {
+      continue;
+    }
+    cur_page = AppendPage(root_page, cur_page, txn);
+    inserted = cur_page != nullptr && cur_page->InsertTuple(rows[i], schema_, txn, lock_manager_, log_manager_);
+  }
+  if (cur_page != nullptr) {
+    ReleasePage(cur_page);
+  }
+  buffer_pool_manager_->UnpinPage(fsm_root_page_id_, true);
+  return inserted;
+}
+
+bool TableHeap::InsertIntoTail(Row &row, Transaction *txn) {
+  auto root_page = buffer_pool_manager_->FetchPage(fsm_root_page_id_);
+  if (root_page == nullptr) {
+    return false;
+  }
+  bool inserted = false;
+  auto last_page = LatchTailPage(root_page);
+  // the last page is not in the map if the map is full
+  if (last_page != nullptr && last_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_)) {
+    ReleasePage(last_page);
+    inserted = true;
+  } else if (last_page != nullptr) {
+    auto new_page = AppendPage(root_page, last_page, txn);
+    if (new_page != nullptr) {
+      inserted = new_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+      ReleasePage(new_page);
+    }
+  }
+  buffer_pool_manager_->UnpinPage(fsm_root_page_id_, true);
+  return inserted;
+}
+
+TablePage *TableHeap::LatchTailPage(Page *root_page) {
+  root_page->RLatch();
+  page_id_t page_id = reinterpret_cast<FreeSpaceMapPage *>(root_page->GetData())->GetLastPageId();
+  root_page->RUnlatch();
+  // another writer may have appended pages since, only one page is latched at a time while following them
+  while (true) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (page == nullptr) {
+      return nullptr;
+    }
+    page->WLatch();
+    page_id_t next_page_id = page->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      return page;
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+TablePage *TableHeap::AppendPage(Page *root_page, TablePage *last_page, Transaction *txn) {
+  auto root = reinterpret_cast<FreeSpaceMapPage *>(root_page->GetData());
+  page_id_t next_page_id;
+  // pages of one owner come from a reserved run, so consecutive new pages are contiguous on disk
+  auto new_page = static_cast<TablePage *>(
+          buffer_pool_manager_->NewPage(next_page_id, DiskFileMetaPage::TableHeapOwner(first_page_id_)));
+  // The leaf of the new page is pinned before the page is linked, a linked page which can not be tracked would
+  // leave a hole in the page directory.
+  Page *leaf_page = nullptr;
+  if (new_page != nullptr && !PinLastLeaf(root, &leaf_page)) {
+    buffer_pool_manager_->UnpinPage(next_page_id, false);
+    buffer_pool_manager_->DeletePage(next_page_id);
+    new_page = nullptr;
+  }
+  if (new_page == nullptr) {
+    last_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(last_page->GetTablePageId(), false);
+    return nullptr;
+  }
+  new_page->WLatch();
+  page_id_t last_page_id = last_page->GetTablePageId();
+  page_id_t fsm_page_id = last_page->GetFreeSpaceMapPageId();
+  uint32_t free_space = last_page->GetFreeSpaceRemaining();
+  last_page->SetNextPageId(next_page_id);
+  new_page->Init(next_page_id, last_page_id, log_manager_, txn);
+  last_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(last_page_id, true);
+  // The new page is not in the map yet, so nobody waits for it while holding the root or a leaf.
+  root_page->WLatch();
+  SetFreeSpace(root, fsm_page_id, last_page_id, free_space);
+  root->SetLastPageId(next_page_id);
+  TrackPage(root, leaf_page, new_page);
+  root_page->WUnlatch();
+  return new_page;
+}
+
+void TableHeap::ReleasePage(TablePage *page) {
+  page_id_t page_id = page->GetTablePageId();
+  page_id_t fsm_page_id = page->GetFreeSpaceMapPageId();
+  uint32_t free_space = page->GetFreeSpaceRemaining();
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  UpdateFreeSpace(fsm_page_id, page_id, free_space);
+}
+
+void TableHeap::CreateFreeSpaceMap(TablePage *first_page) {
+  auto owner_id = DiskFileMetaPage::TableHeapOwner(first_page_id_);
+  auto root_page = buffer_pool_manager_->NewPage(fsm_root_page_id_, owner_id);
+  ASSERT(root_page != nullptr, "Couldn't create a free space map for the table heap.");
+  auto root = reinterpret_cast<FreeSpaceMapPage *>(root_page->GetData());
+  root->Init(fsm_root_page_id_, fsm_root_page_id_);
+  root->SetLastPageId(first_page_id_);
+  Page *leaf_page;
+  [[maybe_unused]] bool pinned = PinLastLeaf(root, &leaf_page);
+  ASSERT(pinned, "Couldn't create a free space map leaf for the table heap.");
+  TrackPage(root, leaf_page, first_page);
+  buffer_pool_manager_->UnpinPage(fsm_root_page_id_, true);
+}
+
+page_id_t TableHeap::FindFreeSpaceMapRoot() {
+  auto first_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+  ASSERT(first_page != nullptr, "Couldn't find the first page of the table heap.");
+  page_id_t leaf_page_id = first_page->GetFreeSpaceMapPageId();
+  buffer_pool_manager_->UnpinPage(first_page_id_, false);
+  auto leaf_page = buffer_pool_manager_->FetchPage(leaf_page_id);
+  ASSERT(leaf_page != nullptr, "Couldn't find the free space map of the table heap.");
+  page_id_t root_page_id = reinterpret_cast<FreeSpaceMapPage *>(leaf_page->GetData())->GetRootPageId();
+  buffer_pool_manager_->UnpinPage(leaf_page_id, false);
+  return root_page_id;
+}
+
+bool TableHeap::PinLastLeaf(FreeSpaceMapPage *root, Page **leaf_page) {
+  *leaf_page = nullptr;
+  // Entries are only added by the writer holding the last page of the chain, the caller, so the entries of the
+  // root and of its last leaf can be read without their latches.
+  if (root->GetCount() > 0) {
+    page_id_t leaf_page_id = root->GetEntryPageId(root->GetCount() - 1);
+    auto page = buffer_pool_manager_->FetchPage(leaf_page_id);
+    if (page == nullptr) {
+      return false;
+    }
+    if (!reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->IsFull()) {
+      *leaf_page = page;
+      return true;
+    }
+    buffer_pool_manager_->UnpinPage(leaf_page_id, false);
+  }
+  if (root->IsFull()) {
+    // the page is only found as the last page of the chain, and so are all pages after it
+    return true;
+  }
+  page_id_t leaf_page_id;
+  *leaf_page = buffer_pool_manager_->NewPage(leaf_page_id, DiskFileMetaPage::TableHeapOwner(first_page_id_));
+  if (*leaf_page == nullptr) {
+    return false;
+  }
+  reinterpret_cast<FreeSpaceMapPage *>((*leaf_page)->GetData())->Init(leaf_page_id, root->GetPageId());
   return true;
 }
+
+void TableHeap::TrackPage(FreeSpaceMapPage *root, Page *leaf_page, TablePage *page) {
+  if (leaf_page == nullptr) {
+    return;
+  }
+  page_id_t leaf_page_id = leaf_page->GetPageId();
+  if (root->GetCount() == 0 || root->GetEntryPageId(root->GetCount() - 1) != leaf_page_id) {
+    // a new leaf
+    root->Append(leaf_page_id, 0);
+  }
+  leaf_page->WLatch();
+  auto leaf = reinterpret_cast<FreeSpaceMapPage *>(leaf_page->GetData());
+  leaf->Append(page->GetTablePageId(), FreeSpaceMapPage::ToBucket(page->GetFreeSpaceRemaining()));
+  root->SetBucket(root->GetCount() - 1, leaf->GetMaxBucket());
+  page->SetFreeSpaceMapPageId(leaf_page_id);
+  leaf_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(leaf_page_id, true);
+}
+
+void TableHeap::UpdateFreeSpace(page_id_t fsm_page_id, page_id_t page_id, uint32_t free_space) {
+  if (fsm_page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  auto leaf_page = buffer_pool_manager_->FetchPage(fsm_page_id);
+  if (leaf_page == nullptr) {
+    return;
+  }
+  leaf_page->WLatch();
+  auto leaf = reinterpret_cast<FreeSpaceMapPage *>(leaf_page->GetData());
+  uint8_t max_bucket = leaf->GetMaxBucket();
+  int slot = leaf->FindPage(page_id);
+  if (slot != -1) {
+    leaf->SetBucket(slot, FreeSpaceMapPage::ToBucket(free_space));
+  }
+  bool grown = leaf->GetMaxBucket() > max_bucket;
+  leaf_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(fsm_page_id, slot != -1);
+  // Most updates do not grow the largest bucket of the leaf and leave the root alone. A root entry which is too
+  // large is corrected by the next insert which finds no room in the leaf.
+  if (grown) {
+    RefreshLeafBucket(fsm_page_id);
+  }
+}
+
+void TableHeap::SetFreeSpace(FreeSpaceMapPage *root, page_id_t fsm_page_id, page_id_t page_id, uint32_t free_space) {
+  if (fsm_page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  auto leaf_page = buffer_pool_manager_->FetchPage(fsm_page_id);
+  if (leaf_page == nullptr) {
+    return;
+  }
+  leaf_page->WLatch();
+  auto leaf = reinterpret_cast<FreeSpaceMapPage *>(leaf_page->GetData());
+  int slot = leaf->FindPage(page_id);
+  int leaf_slot = root->FindPage(fsm_page_id);
+  if (slot != -1 && leaf_slot != -1) {
+    leaf->SetBucket(slot, FreeSpaceMapPage::ToBucket(free_space));
+    root->SetBucket(leaf_slot, leaf->GetMaxBucket());
+  }
+  leaf_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(fsm_page_id, true);
+}
+
+bool TableHeap::RefreshLeafBucket(page_id_t leaf_page_id) {
+  auto root_page = buffer_pool_manager_->FetchPage(fsm_root_page_id_);
+  if (root_page == nullptr) {
+    return false;
+  }
+  auto leaf_page = buffer_pool_manager_->FetchPage(leaf_page_id);
+  if (leaf_page == nullptr) {
+    buffer_pool_manager_->UnpinPage(fsm_root_page_id_, false);
+    return false;
+  }
+  // the leaf is read under the root latch, so the last of two concurrent refreshes stores the current bucket
+  root_page->WLatch();
+  leaf_page->RLatch();
+  auto root = reinterpret_cast<FreeSpaceMapPage *>(root_page->GetData());
+  int leaf_slot = root->FindPage(leaf_page_id);
+  if (leaf_slot != -1) {
+    root->SetBucket(leaf_slot, reinterpret_cast<FreeSpaceMapPage *>(leaf_page->GetData())->GetMaxBucket());
+  }
+  leaf_page->RUnlatch();
+  root_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(leaf_page_id, false);
+  buffer_pool_manager_->UnpinPage(fsm_root_page_id_, true);
+  return true;
+}
+
 bool TableHeap::MarkDelete(const RowId &rid, Transaction *txn) {
   // Find the page which contains the tuple.
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
@@ -72,8 +347,13 @@ bool TableHeap::UpdateTuple(const Row &row, const RowId &rid, Transaction *txn)
   Row old_row(rid);
   page->WLatch();
   bool is_updated = page->UpdateTuple(row, &old_row , schema_,txn, lock_manager_, log_manager_);
+  page_id_t fsm_page_id = page->GetFreeSpaceMapPageId();
+  uint32_t free_space = page->GetFreeSpaceRemaining();
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_updated);
+  if (is_updated) {
+    UpdateFreeSpace(fsm_page_id, rid.GetPageId(), free_space);
+  }
   return is_updated;
 }
 
@@ -84,8 +364,12 @@ void TableHeap::ApplyDelete(const RowId &rid, Transaction *txn) {
   // Delete the tuple from the page.
   page->WLatch();
   page->ApplyDelete(rid, txn, log_manager_);
+  page_id_t fsm_page_id = page->GetFreeSpaceMapPageId();
+  uint32_t free_space = page->GetFreeSpaceRemaining();
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  // the map is updated without the page latched, inserts latch the map first
+  UpdateFreeSpace(fsm_page_id, rid.GetPageId(), free_space);
 }
 
 void TableHeap::RollbackDelete(const RowId &rid, Transaction *txn) {
@@ -122,22 +406,127 @@ bool TableHeap::GetTuple(Row *row, Transaction *txn) {
   return res;
 }
 
-TableIterator TableHeap::Begin(Transaction *txn) {
+void TableHeap::Scan(const std::function<bool(const RowView &)> &visitor, Transaction *txn) {
+  auto strategy = std::make_shared<BufferAccessStrategy>();
+  auto page_id = first_page_id_;
+  bool more = true;
+  while (more && page_id != INVALID_PAGE_ID) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id, strategy.get()));
+    if (page == nullptr) {
+      return;
+    }
+    page->RLatch();
+    auto next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->PrefetchChain(next_page_id, TablePage::GetNextPageId, DEFAULT_PREFETCH_DEPTH, strategy);
+    RowId rid;
+    RowView view;
+    for (bool found = page->GetFirstTupleRid(&rid); more && found; found = page->GetNextTupleRid(rid, &rid)) {
+      if (page->GetTupleView(rid, schema_, &view)) {
+        more = visitor(view);
+      }
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+bool TableHeap::GetPageIds(std::vector<page_id_t> *page_ids) {
+  page_ids->clear();
+  auto root_page = buffer_pool_manager_->FetchPage(fsm_root_page_id_);
+  if (root_page == nullptr) {
+    return false;
+  }
+  root_page->RLatch();
+  auto root = reinterpret_cast<FreeSpaceMapPage *>(root_page->GetData());
+  page_id_t last_page_id = root->GetLastPageId();
+  bool success = true;
+  for (uint32_t leaf_slot = 0; success && leaf_slot < root->GetCount(); leaf_slot++) {
+    auto leaf_page = buffer_pool_manager_->FetchPage(root->GetEntryPageId(leaf_slot));
+    if (leaf_page == nullptr) {
+      success = false;
+      break;
+    }
+    leaf_page->RLatch();
+    auto leaf = reinterpret_cast<FreeSpaceMapPage *>(leaf_page->GetData());
+    for (uint32_t slot = 0; slot < leaf->GetCount(); slot++) {
+      page_ids->push_back(leaf->GetEntryPageId(slot));
+    }
+    leaf_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+  }
+  root_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(fsm_root_page_id_, false);
+  // untracked pages at the tail
+  while (success && !page_ids->empty() && page_ids->back() != last_page_id) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_ids->back()));
+    if (page == nullptr) {
+      return false;
+    }
+    page->RLatch();
+    page_id_t next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_ids->back(), false);
+    if (next_page_id == INVALID_PAGE_ID) {
+      break;
+    }
+    page_ids->push_back(next_page_id);
+  }
+  return success;
+}
+
+BatchScanCursor TableHeap::BeginBatchScan() {
+  BatchScanCursor cursor;
+  cursor.page_id_ = first_page_id_;
+  cursor.strategy_ = std::make_shared<BufferAccessStrategy>();
+  return cursor;
+}
+
+bool TableHeap::ScanBatch(BatchScanCursor *cursor, ColumnBatch *batch, Transaction *txn) {
+  batch->Reset();
+  while (!batch->IsFull() && cursor->page_id_ != INVALID_PAGE_ID) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(cursor->page_id_, cursor->strategy_.get()));
+    if (page == nullptr) {
+      return false;
+    }
+    page->RLatch();
+    if (cursor->slot_num_ == 0) {
+      // first visit of the page
+      buffer_pool_manager_->PrefetchChain(page->GetNextPageId(), TablePage::GetNextPageId, DEFAULT_PREFETCH_DEPTH,
+                                          cursor->strategy_);
+    }
+    cursor->slot_num_ = page->DecodeTuples(cursor->slot_num_, batch);
+    if (cursor->slot_num_ == page->GetTupleCount()) {
+      cursor->page_id_ = page->GetNextPageId();
+      cursor->slot_num_ = 0;
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
+  }
+  return true;
+}
+
+TableIterator TableHeap::Begin(Transaction *txn, ArenaMemHeap *heap) {
+  // A full scan must not flush the shared buffer pool, it recycles the frames of a small private ring instead.
+  auto strategy = std::make_shared<BufferAccessStrategy>();
   RowId rid;
   auto page_id = first_page_id_;
   while (page_id != INVALID_PAGE_ID) {
-    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id, strategy.get()));
     page->RLatch();
     // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
     auto found_tuple = page->GetFirstTupleRid(&rid);
+    auto next_page_id = page->GetNextPageId();
     page->RUnlatch();
     buffer_pool_manager_->UnpinPage(page_id, false);
     if (found_tuple) {
+      // read ahead while the first page is consumed
+      buffer_pool_manager_->PrefetchChain(next_page_id, TablePage::GetNextPageId, DEFAULT_PREFETCH_DEPTH, strategy);
       break;
     }
-    page_id = page->GetNextPageId();
+    page_id = next_page_id;
   }
-  return TableIterator(this, rid, txn);
+  return TableIterator(this, rid, txn, strategy, heap);
 }
 
 TableIterator TableHeap::End() {
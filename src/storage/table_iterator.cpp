@@ -2,19 +2,79 @@
 #include "storage/table_iterator.h"
 #include "storage/table_heap.h"
 
-TableIterator::TableIterator(TableHeap *table_heap, RowId rid, Transaction *txn)
-    : table_heap_(table_heap), row_(new Row(rid)), txn_(txn) {
-  if (rid.GetPageId() != INVALID_PAGE_ID) {
-    table_heap_->GetTuple(row_, txn_);
+TableIterator::TableIterator(TableHeap *table_heap, RowId rid, Transaction *txn,
+                             std::shared_ptr<BufferAccessStrategy> strategy, ArenaMemHeap *heap)
+    : table_heap_(table_heap), row_(nullptr), txn_(txn), strategy_(std::move(strategy)), parent_heap_(heap),
+      heap_(NewHeap()) {
+  ResetRow(rid);
+  Load(rid);
+}
+
+TableIterator::TableIterator(const TableIterator &other)
+    : table_heap_(other.table_heap_), txn_(other.txn_), strategy_(other.strategy_),
+      parent_heap_(other.parent_heap_), heap_(NewHeap()) {
+  row_ = other.row_ == nullptr ? ALLOC_P(heap_, Row)(other.GetRowId(), heap_) : ALLOC_P(heap_, Row)(*other.row_);
+  if (other.page_ != nullptr) {
+    // every copy holds its own pin
+    page_ = static_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(other.page_->GetTablePageId()));
   }
 }
 
+TableIterator::TableIterator(TableIterator &&other) noexcept
+    : table_heap_(other.table_heap_), row_(other.row_), txn_(other.txn_), strategy_(std::move(other.strategy_)),
+      page_(other.page_), parent_heap_(other.parent_heap_), heap_(other.heap_) {
+  other.row_ = nullptr;
+  other.page_ = nullptr;
+  other.heap_ = nullptr;
+}
+
 TableIterator::~TableIterator() {
-  delete row_; 
+  Release();
+  if (row_ != nullptr) {
+    row_->~Row();
+  }
+  if (parent_heap_ == nullptr) {
+    delete heap_;
+  } else if (heap_ != nullptr) {
+    parent_heap_->ReleaseChild(heap_);
+  }
+}
+
+TableIterator &TableIterator::operator=(const TableIterator &other) {
+  if (this != &other) {
+    Release();
+    if (row_ != nullptr) {
+      row_->~Row();
+      row_ = nullptr;
+    }
+    if (heap_ == nullptr) {
+      heap_ = NewHeap();
+    }
+    heap_->Reset();
+    table_heap_ = other.table_heap_;
+    row_ = other.row_ == nullptr ? ALLOC_P(heap_, Row)(other.GetRowId(), heap_) : ALLOC_P(heap_, Row)(*other.row_);
+    txn_ = other.txn_;
+    strategy_ = other.strategy_;
+    if (other.page_ != nullptr) {
+      page_ = static_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(other.page_->GetTablePageId()));
+    }
+  }
+  return *this;
+}
+
+TableIterator &TableIterator::operator=(TableIterator &&other) noexcept {
+  std::swap(table_heap_, other.table_heap_);
+  std::swap(row_, other.row_);
+  std::swap(txn_, other.txn_);
+  std::swap(strategy_, other.strategy_);
+  std::swap(page_, other.page_);
+  std::swap(parent_heap_, other.parent_heap_);
+  std::swap(heap_, other.heap_);
+  return *this;
 }
 
 bool TableIterator::operator==(const TableIterator &itr) const {
-  return row_->GetRowId().Get() == itr.row_->GetRowId().Get();
+  return GetRowId().Get() == itr.GetRowId().Get();
 }
 
 bool TableIterator::operator!=(const TableIterator &itr) const { return !(*this == itr); }
@@ -30,37 +90,80 @@ Row *TableIterator::operator->() {
 }
 
 TableIterator &TableIterator::operator++() {
+  ASSERT(page_ != nullptr, "Increment past the end.");
   BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(row_->GetRowId().GetPageId()));
-  cur_page->RLatch();
-  assert(cur_page != nullptr);  // all pages are pinned
-
   RowId next_tuple_rid;
-  if (!cur_page->GetNextTupleRid(row_->GetRowId(),
-                                 &next_tuple_rid)) {  // end of this page
-    while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
-      cur_page->RUnlatch();
-      buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
-      cur_page = next_page;
-      cur_page->RLatch();
-      if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
-        break;
-      }
-    }
+  page_->RLatch();
+  bool found = page_->GetNextTupleRid(row_->GetRowId(), &next_tuple_rid);
+  // end of this page, move the pin to the next page holding a tuple
+  while (!found && page_->GetNextPageId() != INVALID_PAGE_ID) {
+    page_id_t next_page_id = page_->GetNextPageId();
+    page_->RUnlatch();
+    Release();
+    page_ = static_cast<TablePage *>(buffer_pool_manager->FetchPage(next_page_id, strategy_.get()));
+    ASSERT(page_ != nullptr, "Couldn't fetch the next page of the table heap.");
+    page_->RLatch();
+    // keep the read ahead window DEFAULT_PREFETCH_DEPTH pages in front of the scan
+    buffer_pool_manager->PrefetchChain(page_->GetNextPageId(), TablePage::GetNextPageId, DEFAULT_PREFETCH_DEPTH,
+                                       strategy_);
+    found = page_->GetFirstTupleRid(&next_tuple_rid);
   }
-  row_->SetRowId(next_tuple_rid);
-
-  if (*this != table_heap_->End()) {
-    table_heap_->GetTuple(row_,txn_);
+  ResetRow(next_tuple_rid);
+  if (found) {
+    page_->GetTuple(row_, table_heap_->schema_, txn_, table_heap_->lock_manager_);
+    page_->RUnlatch();
+  } else {
+    page_->RUnlatch();
+    Release();
   }
-  // release until copy the tuple
-  cur_page->RUnlatch();
-  buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
   return *this;
 }
 
 TableIterator TableIterator::operator++(int) {
-  ++(*this);
-  return TableIterator(*this);
+  // the returned iterator takes the row, its arena and the pin, this one starts a new arena and pins the page
+  // again to move on from the rid with its buffer ring
+  TableIterator old(std::move(*this));
+  strategy_ = old.strategy_;
+  heap_ = NewHeap();
+  row_ = ALLOC_P(heap_, Row)(old.GetRowId(), heap_);
+  if (old.page_ != nullptr) {
+    page_ = static_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(old.page_->GetTablePageId()));
+    ++(*this);
+  }
+  return old;
+}
+
+RowId TableIterator::GetRowId() const {
+  return row_ == nullptr ? RowId(INVALID_PAGE_ID, 0) : row_->GetRowId();
+}
+
+void TableIterator::ResetRow(RowId rid) {
+  if (row_ != nullptr) {
+    row_->~Row();
+  }
+  heap_->Reset();
+  row_ = ALLOC_P(heap_, Row)(rid, heap_);
+}
+
+void TableIterator::Load(RowId rid) {
+  if (rid.GetPageId() == INVALID_PAGE_ID) {
+    return;
+  }
+  page_ = static_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(rid.GetPageId(), strategy_.get()));
+  ASSERT(page_ != nullptr, "Couldn't fetch the page of the table heap.");
+  page_->RLatch();
+  page_->GetTuple(row_, table_heap_->schema_, txn_, table_heap_->lock_manager_);
+  page_->RUnlatch();
+}
+
+ArenaMemHeap *TableIterator::NewHeap() const {
+  return parent_heap_ == nullptr ? new ArenaMemHeap(ROW_ARENA_CHUNK_SIZE)
+                                 : parent_heap_->CreateChild(ROW_ARENA_CHUNK_SIZE);
+}
+
+void TableIterator::Release() {
+  if (page_ != nullptr) {
+    table_heap_->buffer_pool_manager_->UnpinPage(page_->GetTablePageId(), false);
+    page_ = nullptr;
+  }
 }
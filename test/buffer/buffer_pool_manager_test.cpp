@@ -1,6 +1,10 @@
+#include <atomic>
 #include <cstdio>
 #include <random>
+#include <set>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
@@ -70,4 +74,257 @@ TEST(BufferPoolManagerTest, BinaryDataTest) {
 
   delete bpm;
   delete disk_manager;
-}
\ No newline at end of file
+}
+
+TEST(BufferPoolManagerTest, BufferAccessStrategyTest) {
+  const std::string db_name = "bpm_strategy_test.db";
+  const size_t buffer_pool_size = 10;
+  const size_t num_scan_pages = 40;
+  const size_t num_hot_pages = 5;
+  const size_t ring_size = 3;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  // Pages [0, num_scan_pages) belong to the scanned table, the hot pages come right after them.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < num_scan_pages + num_hot_pages; ++i) {
+    auto *page = bpm->NewPage(page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page-%d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: the hot pages are the most recently used ones in the pool.
+  std::vector<Page *> hot_frames;
+  for (size_t i = num_scan_pages; i < num_scan_pages + num_hot_pages; ++i) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    hot_frames.push_back(page);
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+
+  // Scenario: a scan through a strategy only ever uses ring_size frames for pages that miss the pool.
+  BufferAccessStrategy strategy(ring_size);
+  std::set<Page *> scan_frames;
+  for (size_t i = 0; i < num_scan_pages - buffer_pool_size; ++i) {
+    auto page_id = static_cast<page_id_t>(i);
+    auto *page = bpm->FetchPage(page_id, &strategy);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page-" + std::to_string(page_id), std::string(page->GetData()));
+    scan_frames.insert(page);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(ring_size, scan_frames.size());
+
+  // Scenario: the hot pages survived the scan in their original frames.
+  for (size_t i = 0; i < num_hot_pages; ++i) {
+    auto page_id = static_cast<page_id_t>(num_scan_pages + i);
+    auto *page = bpm->FetchPage(page_id);
+    EXPECT_EQ(hot_frames[i], page);
+    EXPECT_EQ("page-" + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, DeferredWriteBackTest) {
+  const std::string db_name = "bpm_flush_test.db";
+  const size_t buffer_pool_size = 10;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page-%d", page_id);
+    page_ids.push_back(page_id);
+  }
+
+  // Scenario: pinned dirty pages are never picked up by the flusher.
+  EXPECT_EQ(0, bpm->FlushDirtyPages());
+
+  // Scenario: unpinning only marks the pages dirty, the background flusher writes them back.
+  for (auto page_id : page_ids) {
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  char buf[PAGE_SIZE];
+  for (auto page_id : page_ids) {
+    std::string expected = "page-" + std::to_string(page_id);
+    for (int retry = 0; retry < 100; retry++) {
+      disk_manager->ReadPage(page_id, buf);
+      if (expected == buf) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(DEFAULT_FLUSH_INTERVAL_MS));
+    }
+    EXPECT_EQ(expected, std::string(buf));
+  }
+  // everything is clean now
+  EXPECT_EQ(0, bpm->FlushDirtyPages());
+
+  // Scenario: a page dirtied again is written on the next round.
+  auto *page = bpm->FetchPage(page_ids[0]);
+  ASSERT_NE(nullptr, page);
+  snprintf(page->GetData(), PAGE_SIZE, "updated");
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[0], true));
+  bpm->FlushDirtyPages();
+  disk_manager->ReadPage(page_ids[0], buf);
+  EXPECT_EQ("updated", std::string(buf));
+
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+/**
+ * Counts the pages read from disk, including the asynchronous reads, and fails reads and writes on request
+ */
+class CountingDiskManager : public DiskManager {
+public:
+  explicit CountingDiskManager(const std::string &db_file) : DiskManager(db_file) {}
+
+  std::atomic<int> num_reads_{0};
+  std::atomic<bool> fail_reads_{false};
+  std::atomic<bool> fail_writes_{false};
+
+protected:
+  bool ReadPhysicalPage(physical_page_id_t physical_page_id, char *page_data) override {
+    num_reads_++;
+    if (fail_reads_) {
+      memset(page_data, 0, PAGE_SIZE);
+      return false;
+    }
+    return DiskManager::ReadPhysicalPage(physical_page_id, page_data);
+  }
+
+  bool WritePhysicalPage(physical_page_id_t physical_page_id, const char *page_data) override {
+    return !fail_writes_ && DiskManager::WritePhysicalPage(physical_page_id, page_data);
+  }
+};
+
+TEST(BufferPoolManagerTest, PrefetchChainTest) {
+  const std::string db_name = "bpm_prefetch_test.db";
+  const size_t buffer_pool_size = 10;
+  const int chain_length = 20;
+  // the chain is linked through the first four bytes of each page
+  NextPageIdFn get_next = [](const char *page_data) { return *reinterpret_cast<const page_id_t *>(page_data); };
+
+  remove(db_name.c_str());
+  auto *disk_manager = new CountingDiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  for (int i = 0; i < chain_length; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    *reinterpret_cast<page_id_t *>(page->GetData()) = i + 1 < chain_length ? i + 1 : INVALID_PAGE_ID;
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  delete bpm;
+
+  // Scenario: the chain is loaded in the background, the reader then finds the pages resident.
+  bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  const int depth = 5;
+  disk_manager->num_reads_ = 0;
+  bpm->PrefetchChain(1, get_next, depth);
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  EXPECT_EQ(depth, disk_manager->num_reads_);
+  for (page_id_t page_id = 1; page_id <= depth; page_id++) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(page_id + 1, get_next(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(depth, disk_manager->num_reads_);
+
+  // Scenario: resident pages are followed without I/O, the window moves on from the end of the chain.
+  bpm->PrefetchChain(1, get_next, depth + 2);
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  EXPECT_EQ(depth + 2, disk_manager->num_reads_);
+
+  // Scenario: the chain ends at INVALID_PAGE_ID, and fetching while a prefetch is in flight waits for it.
+  bpm->PrefetchChain(chain_length - 2, get_next, depth);
+  auto *page = bpm->FetchPage(chain_length - 1);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(INVALID_PAGE_ID, get_next(page->GetData()));
+  EXPECT_TRUE(bpm->UnpinPage(chain_length - 1, false));
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  EXPECT_EQ(depth + 4, disk_manager->num_reads_);
+
+  // Scenario: a failed read is reported and leaves nothing behind, neither for a fetch nor for a prefetch.
+  delete bpm;
+  bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  disk_manager->fail_reads_ = true;
+  EXPECT_EQ(nullptr, bpm->FetchPage(3));
+  bpm->PrefetchChain(3, get_next, depth);
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  disk_manager->fail_reads_ = false;
+  page = bpm->FetchPage(3);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(4, get_next(page->GetData()));
+  EXPECT_TRUE(bpm->UnpinPage(3, false));
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, WriteErrorTest) {
+  const std::string db_name = "bpm_write_error_test.db";
+  const size_t buffer_pool_size = 1;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new CountingDiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  page_id_t page_id;
+  auto *page = bpm->NewPage(page_id);
+  ASSERT_NE(nullptr, page);
+  snprintf(page->GetData(), PAGE_SIZE, "page-%d", page_id);
+
+  // Scenario: a dirty page whose write fails is neither evicted nor marked clean, a failed flush is reported.
+  disk_manager->fail_writes_ = true;
+  EXPECT_FALSE(disk_manager->WritePage(page_id, page->GetData()));
+  EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  page_id_t other_page_id;
+  EXPECT_EQ(nullptr, bpm->NewPage(other_page_id));
+  EXPECT_FALSE(bpm->FlushPage(page_id));
+  EXPECT_EQ(nullptr, bpm->NewPage(other_page_id));
+
+  // Scenario: once writes succeed again the page is written back and its frame is reused.
+  disk_manager->fail_writes_ = false;
+  EXPECT_TRUE(bpm->FlushPage(page_id));
+  ASSERT_NE(nullptr, bpm->NewPage(other_page_id));
+  EXPECT_NE(page_id, other_page_id);
+  EXPECT_TRUE(bpm->UnpinPage(other_page_id, false));
+  page = bpm->FetchPage(page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page-" + std::to_string(page_id), std::string(page->GetData()));
+
+  // Scenario: a failed write of the flusher leaves the page dirty, a later round writes it.
+  snprintf(page->GetData(), PAGE_SIZE, "updated");
+  disk_manager->fail_writes_ = true;
+  EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  EXPECT_EQ(0u, bpm->FlushDirtyPages());
+  EXPECT_EQ(nullptr, bpm->NewPage(other_page_id));
+  disk_manager->fail_writes_ = false;
+  bpm->FlushDirtyPages();
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  char buf[PAGE_SIZE];
+  ASSERT_TRUE(disk_manager->ReadPage(page_id, buf));
+  EXPECT_EQ("updated", std::string(buf));
+  EXPECT_EQ(0u, bpm->FlushDirtyPages());
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
@@ -0,0 +1,74 @@
+#include "buffer/lru_k_replacer.h"
+#include "gtest/gtest.h"
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_k_replacer(7, 2);
+
+  // Scenario: access frames 1-6 once, frame 1 twice, and make them all evictable.
+  for (frame_id_t i = 1; i <= 6; i++) {
+    lru_k_replacer.RecordAccess(i);
+  }
+  lru_k_replacer.RecordAccess(1);
+  for (frame_id_t i = 1; i <= 6; i++) {
+    lru_k_replacer.Unpin(i);
+  }
+  EXPECT_EQ(6, lru_k_replacer.Size());
+
+  // Scenario: frames with less than k accesses go first, in order of their first access.
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(4, value);
+
+  // Scenario: pin elements in the replacer.
+  // Note that 3 has already been victimized, so pinning 3 should have no effect.
+  lru_k_replacer.Pin(3);
+  lru_k_replacer.Pin(4);
+  lru_k_replacer.Pin(5);
+  EXPECT_EQ(2, lru_k_replacer.Size());
+
+  // Scenario: frame 5 gets its second access, now 1 and 5 both have k accesses and 6 has not.
+  lru_k_replacer.RecordAccess(5);
+  lru_k_replacer.Unpin(5);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(6, value);
+  // frame 1 has the oldest 2nd most recent access, i.e. the largest backward k-distance
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(5, value);
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+}
+
+TEST(LRUKReplacerTest, ScanResistanceTest) {
+  const int num_frames = 16;
+  LRUKReplacer lru_k_replacer(num_frames, 2);
+
+  // Scenario: frames 0-3 hold hot index pages which are accessed repeatedly.
+  for (int round = 0; round < 3; round++) {
+    for (frame_id_t i = 0; i < 4; i++) {
+      lru_k_replacer.RecordAccess(i);
+    }
+  }
+  for (frame_id_t i = 0; i < 4; i++) {
+    lru_k_replacer.Unpin(i);
+  }
+
+  // Scenario: a sequential scan touches every other frame exactly once, more recently than the hot pages.
+  for (frame_id_t i = 4; i < num_frames; i++) {
+    lru_k_replacer.RecordAccess(i);
+    lru_k_replacer.Unpin(i);
+  }
+
+  // Scenario: all scan frames are evicted before any hot frame.
+  int value;
+  for (int i = 4; i < num_frames; i++) {
+    ASSERT_TRUE(lru_k_replacer.Victim(&value));
+    EXPECT_LE(4, value);
+  }
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_GT(4, value);
+}
@@ -0,0 +1,88 @@
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const std::string db_name = "parallel_bpm_test.db";
+  const size_t num_instances = 4;
+  const size_t buffer_pool_size = 5;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+  ASSERT_EQ(num_instances * buffer_pool_size, bpm->GetPoolSize());
+
+  // Scenario: pages are spread over all instances, so the whole pool can be filled.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_instances * buffer_pool_size; ++i) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(i, page_id);
+    snprintf(page->GetData(), PAGE_SIZE, "page-%d", page_id);
+    page_ids.push_back(page_id);
+  }
+
+  // Scenario: every shard is pinned, no more pages can be created.
+  page_id_t page_id_temp;
+  EXPECT_EQ(nullptr, bpm->NewPage(page_id_temp));
+  EXPECT_FALSE(bpm->CheckAllUnpinned());
+
+  // Scenario: after unpinning, new pages evict the old ones and the old content survives on disk.
+  for (auto page_id : page_ids) {
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  for (size_t i = 0; i < num_instances * buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  for (auto page_id : page_ids) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page-" + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: while one shard is fully pinned, new pages are created in the other shards.
+  std::vector<page_id_t> pinned;
+  for (size_t i = 0; i < page_ids.size(); i += num_instances) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    pinned.push_back(page_ids[i]);
+  }
+  for (size_t i = 0; i < num_instances; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(page_id_temp));
+    EXPECT_NE(0u, page_id_temp % num_instances);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  for (auto page_id : pinned) {
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: concurrent fetches of disjoint pages.
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_instances; t++) {
+    threads.emplace_back([&, t]() {
+      for (int round = 0; round < 100; round++) {
+        for (size_t i = t; i < page_ids.size(); i += num_instances) {
+          auto *page = bpm->FetchPage(page_ids[i]);
+          ASSERT_NE(nullptr, page);
+          EXPECT_EQ("page-" + std::to_string(page_ids[i]), std::string(page->GetData()));
+          bpm->UnpinPage(page_ids[i], false);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
@@ -0,0 +1,132 @@
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "record/column_batch.h"
+#include "record/filter_kernels.h"
+#include "record/row.h"
+
+static const CompareOp ops[] = {CompareOp::kEqual, CompareOp::kNotEqual, CompareOp::kLessThan,
+                                CompareOp::kLessThanEquals, CompareOp::kGreaterThan, CompareOp::kGreaterThanEquals};
+
+template <typename T>
+static bool Expected(CompareOp op, T left, T right) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return left == right;
+    case CompareOp::kNotEqual:
+      return left != right;
+    case CompareOp::kLessThan:
+      return left < right;
+    case CompareOp::kLessThanEquals:
+      return left <= right;
+    case CompareOp::kGreaterThan:
+      return left > right;
+    default:
+      return left >= right;
+  }
+}
+
+TEST(FilterKernelsTest, NumericTest) {
+  // not a multiple of the vector width, so the scalar tail runs too
+  const uint32_t count = 1003;
+  std::mt19937 gen(2022);
+  std::uniform_int_distribution<int32_t> dist(-20, 20);
+  std::vector<int32_t> ints(count), other_ints(count);
+  std::vector<float> floats(count), other_floats(count);
+  for (uint32_t i = 0; i < count; i++) {
+    ints[i] = dist(gen);
+    other_ints[i] = dist(gen);
+    floats[i] = static_cast<float>(dist(gen)) / 4;
+    other_floats[i] = static_cast<float>(dist(gen)) / 4;
+  }
+  floats[17] = NAN;
+  std::vector<uint64_t> bitmap(FilterKernels::GetBitmapSize(count), ~0ull);
+  for (auto op : ops) {
+    FilterKernels::Compare(ints.data(), count, op, 3, bitmap.data());
+    for (uint32_t i = 0; i < count; i++) {
+      ASSERT_EQ(Expected(op, ints[i], 3), FilterKernels::IsSet(bitmap.data(), i));
+    }
+    FilterKernels::Compare(ints.data(), other_ints.data(), count, op, bitmap.data());
+    for (uint32_t i = 0; i < count; i++) {
+      ASSERT_EQ(Expected(op, ints[i], other_ints[i]), FilterKernels::IsSet(bitmap.data(), i));
+    }
+    FilterKernels::Compare(floats.data(), count, op, 0.5f, bitmap.data());
+    for (uint32_t i = 0; i < count; i++) {
+      ASSERT_EQ(Expected(op, floats[i], 0.5f), FilterKernels::IsSet(bitmap.data(), i));
+    }
+    FilterKernels::Compare(floats.data(), other_floats.data(), count, op, bitmap.data());
+    for (uint32_t i = 0; i < count; i++) {
+      ASSERT_EQ(Expected(op, floats[i], other_floats[i]), FilterKernels::IsSet(bitmap.data(), i));
+    }
+    // bits past the count are clear
+    ASSERT_EQ(0u, bitmap.back() >> (count % 64));
+  }
+}
+
+TEST(FilterKernelsTest, ColumnBatchFilterTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+          ALLOC_COLUMN(heap)("nickname", TypeId::kTypeChar, 64, 2, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 3, true, false)
+  };
+  Schema schema(columns);
+  // short names, names sharing a long prefix, names differing by a trailing zero byte, and nulls
+  std::vector<std::string> names = {"", "a", "ab", "b", std::string("ab\0", 3), "abcdefghijklmnopqr",
+                                    "abcdefghijklmnopqs", "abcdefghijklmnop", "zz"};
+  const uint32_t count = 500;
+  ColumnBatch batch(&schema, count);
+  std::vector<int32_t> ids(count);
+  std::vector<std::string> first(count), second(count);
+  std::vector<bool> nulls(count);
+  char buf[PAGE_SIZE];
+  for (uint32_t i = 0; i < count; i++) {
+    ids[i] = static_cast<int32_t>(i % 37);
+    first[i] = names[i % names.size()];
+    second[i] = names[(i / 3) % names.size()];
+    nulls[i] = i % 11 == 0;
+    std::vector<Field> fields = {
+            Field(TypeId::kTypeInt, ids[i]),
+            Field(TypeId::kTypeChar, const_cast<char *>(first[i].data()), first[i].size(), true),
+            nulls[i] ? Field(TypeId::kTypeChar)
+                     : Field(TypeId::kTypeChar, const_cast<char *>(second[i].data()), second[i].size(), true),
+            Field(TypeId::kTypeFloat, static_cast<float>(i % 7))
+    };
+    Row row(fields);
+    row.SerializeTo(buf, &schema);
+    batch.Append(buf, RowId(0, i));
+  }
+  auto selected = [&batch]() {
+    return std::vector<uint32_t>(batch.GetSelection(), batch.GetSelection() + batch.GetSelectedCount());
+  };
+  for (auto op : ops) {
+    for (auto &constant : names) {
+      batch.SetSelectedCount(count);
+      for (uint32_t i = 0; i < count; i++) {
+        batch.GetSelection()[i] = i;
+      }
+      // id < 30 and name op constant and nickname op name
+      batch.Filter(0, CompareOp::kLessThan, 30);
+      batch.Filter(1, op, constant.data(), constant.size());
+      batch.FilterColumns(2, op, 1);
+      std::vector<uint32_t> expected;
+      for (uint32_t i = 0; i < count; i++) {
+        if (ids[i] < 30 && Expected(op, first[i], constant) && !nulls[i] && Expected(op, second[i], first[i])) {
+          expected.push_back(i);
+        }
+      }
+      ASSERT_EQ(expected, selected());
+    }
+  }
+  batch.SetSelectedCount(count);
+  for (uint32_t i = 0; i < count; i++) {
+    batch.GetSelection()[i] = i;
+  }
+  batch.Filter(3, CompareOp::kGreaterThanEquals, 5.0f);
+  ASSERT_EQ(count / 7 * 2 + (count % 7 > 5 ? 1 : 0), batch.GetSelectedCount());
+}
@@ -87,6 +87,28 @@ TEST(TupleTest, FieldSerializeDeserializeTest) {
   }
 }
 
+TEST(TupleTest, FieldMoveTest) {
+  // short strings are kept in the field, longer ones are copied once and then handed over
+  char short_chars[] = "minisql";
+  Field short_field(TypeId::kTypeChar, short_chars, strlen(short_chars), true);
+  auto field_begin = reinterpret_cast<const char *>(&short_field);
+  ASSERT_TRUE(short_field.GetData() >= field_begin && short_field.GetData() < field_begin + sizeof(Field));
+  Field short_copy(short_field);
+  ASSERT_EQ(CmpBool::kTrue, short_copy.CompareEquals(short_field));
+  std::string long_string(64, 'x');
+  Field long_field(TypeId::kTypeChar, const_cast<char *>(long_string.c_str()), long_string.size(), true);
+  const char *long_data = long_field.GetData();
+  Field moved(std::move(long_field));
+  ASSERT_EQ(long_data, moved.GetData());
+  std::vector<Field> fields = {Field(TypeId::kTypeInt, 188), Field(moved)};
+  Row row(fields);
+  Field *first_field = row.GetField(0);
+  Row moved_row(std::move(row));
+  ASSERT_EQ(first_field, moved_row.GetField(0));
+  ASSERT_EQ(0u, row.GetFieldCount());
+  ASSERT_EQ(CmpBool::kTrue, moved_row.GetField(1)->CompareEquals(moved));
+}
+
 TEST(TupleTest, RowTest) {
   SimpleMemHeap heap;
   TablePage table_page;
@@ -117,4 +139,143 @@ TEST(TupleTest, RowTest) {
   }
   ASSERT_TRUE(table_page.MarkDelete(row.GetRowId(), nullptr, nullptr, nullptr));
   table_page.ApplyDelete(row.GetRowId(), nullptr, nullptr);
-}
\ No newline at end of file
+}
+
+TEST(TupleTest, RowFormatTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 0, true, false),
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 1, false, false),
+          ALLOC_COLUMN(heap)("nickname", TypeId::kTypeChar, 64, 2, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 3, true, false),
+          ALLOC_COLUMN(heap)("comment", TypeId::kTypeChar, 64, 4, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  const RowCodec &codec = schema->GetRowCodec();
+  // bitmap, int, float, three end offsets
+  ASSERT_EQ(1u, codec.GetFieldOffset(1));
+  ASSERT_EQ(5u, codec.GetFieldOffset(3));
+  ASSERT_EQ(9u, codec.GetVarTableOffset());
+  ASSERT_EQ(21u, codec.GetFixedSize());
+  std::vector<Field> fields = {
+          Field(TypeId::kTypeChar, chars[1], strlen(chars[1]), false),
+          Field(TypeId::kTypeInt, 188),
+          Field(TypeId::kTypeChar),
+          Field(TypeId::kTypeFloat),
+          Field(TypeId::kTypeChar, chars[2], strlen(chars[2]), false)
+  };
+  Row row(fields);
+  char buffer[PAGE_SIZE];
+  uint32_t size = row.SerializeTo(buffer, schema.get());
+  ASSERT_EQ(row.GetSerializedSize(schema.get()), size);
+  ASSERT_EQ(codec.GetFixedSize() + strlen(chars[1]) + strlen(chars[2]), size);
+  // every column is reached without decoding the others
+  std::vector<bool> nulls = {false, false, true, true, false};
+  for (uint32_t i = 0; i < nulls.size(); i++) {
+    ASSERT_EQ(nulls[i], RowCodec::IsNull(buffer, i));
+  }
+  uint32_t len;
+  ASSERT_EQ(188, MACH_READ_FROM(int32_t, codec.GetFieldData(buffer, 1, &len)));
+  const char *comment = codec.GetFieldData(buffer, 4, &len);
+  ASSERT_EQ(std::string(chars[2]), std::string(comment, len));
+  codec.GetFieldData(buffer, 2, &len);
+  ASSERT_EQ(0u, len);
+  Row row2(RowId(0, 0));
+  ASSERT_EQ(size, row2.DeserializeFrom(buffer, schema.get()));
+  ASSERT_EQ(fields.size(), row2.GetFieldCount());
+  for (uint32_t i = 0; i < fields.size(); i++) {
+    ASSERT_EQ(nulls[i], row2.GetField(i)->IsNull());
+    if (!nulls[i]) {
+      ASSERT_EQ(CmpBool::kTrue, row2.GetField(i)->CompareEquals(fields[i]));
+    }
+  }
+  // a schema allocated from a heap keeps the layout of its codec there, it is released with the heap
+  ArenaMemHeap schema_heap;
+  Schema *copy = Schema::DeepCopySchema(schema.get(), &schema_heap);
+  ASSERT_EQ(codec.GetFixedSize(), copy->GetRowCodec().GetFixedSize());
+  char copy_buffer[PAGE_SIZE];
+  ASSERT_EQ(size, row.SerializeTo(copy_buffer, copy));
+  ASSERT_EQ(0, memcmp(buffer, copy_buffer, size));
+}
+
+TEST(TupleTest, SlotReuseTest) {
+  SimpleMemHeap heap;
+  TablePage table_page;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  auto make_row = [](int32_t id, const std::string &name) {
+    std::vector<Field> fields = {
+            Field(TypeId::kTypeInt, id),
+            Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)
+    };
+    return Row(fields);
+  };
+  table_page.Init(0, INVALID_PAGE_ID, nullptr, nullptr);
+  // fill the page with tuples of the same size, the tuple with id i is in slot i
+  std::vector<std::string> names;
+  for (int32_t i = 0;; i++) {
+    std::string number = std::to_string(i);
+    std::string name = "tuple-" + std::string(4 - number.size(), '0') + number;
+    Row row = make_row(i, name);
+    if (!table_page.InsertTuple(row, schema.get(), nullptr, nullptr, nullptr)) {
+      break;
+    }
+    ASSERT_EQ(static_cast<uint32_t>(i), row.GetRowId().GetSlotNum());
+    names.push_back(name);
+  }
+  uint32_t tuple_count = table_page.GetTupleCount();
+  ASSERT_GT(tuple_count, 10u);
+  auto remove = [&](uint32_t slot) {
+    RowId rid(0, slot);
+    ASSERT_TRUE(table_page.MarkDelete(rid, nullptr, nullptr, nullptr));
+    table_page.ApplyDelete(rid, nullptr, nullptr);
+  };
+  // a slot freed on the full page takes a tuple of the same size
+  remove(9);
+  Row row0 = make_row(1009, "tuple-1009");
+  ASSERT_TRUE(table_page.InsertTuple(row0, schema.get(), nullptr, nullptr, nullptr));
+  ASSERT_EQ(9u, row0.GetRowId().GetSlotNum());
+  names[9] = "tuple-1009";
+  // freed slots are reused last in, first out, without adding new slots
+  remove(3);
+  remove(7);
+  Row row = make_row(1007, "tuple-1007");
+  ASSERT_TRUE(table_page.InsertTuple(row, schema.get(), nullptr, nullptr, nullptr));
+  ASSERT_EQ(7u, row.GetRowId().GetSlotNum());
+  names[7] = "tuple-1007";
+  Row row2 = make_row(1003, "tuple-1003");
+  ASSERT_TRUE(table_page.InsertTuple(row2, schema.get(), nullptr, nullptr, nullptr));
+  ASSERT_EQ(3u, row2.GetRowId().GetSlotNum());
+  names[3] = "tuple-1003";
+  ASSERT_EQ(tuple_count, table_page.GetTupleCount());
+  // the holes of interior tuples only fit a larger tuple once the page is compacted
+  remove(2);
+  remove(5);
+  std::string long_name = "tuple-" + std::string(14, 'x');
+  Row row3 = make_row(1005, long_name);
+  ASSERT_TRUE(table_page.InsertTuple(row3, schema.get(), nullptr, nullptr, nullptr));
+  ASSERT_EQ(5u, row3.GetRowId().GetSlotNum());
+  names[5] = long_name;
+  // growing a tuple moves it, shrinking it leaves a hole
+  Row old_row(RowId(0, 4));
+  Row grown = make_row(1004, "tuple-1004-grown");
+  ASSERT_TRUE(table_page.UpdateTuple(grown, &old_row, schema.get(), nullptr, nullptr, nullptr));
+  names[4] = "tuple-1004-grown";
+  Row old_row2(RowId(0, 6));
+  Row shrunk = make_row(1006, "t6");
+  ASSERT_TRUE(table_page.UpdateTuple(shrunk, &old_row2, schema.get(), nullptr, nullptr, nullptr));
+  names[6] = "t6";
+  for (uint32_t slot = 0; slot < tuple_count; slot++) {
+    Row result(RowId(0, slot));
+    if (slot == 2) {
+      ASSERT_FALSE(table_page.GetTuple(&result, schema.get(), nullptr, nullptr));
+      continue;
+    }
+    ASSERT_TRUE(table_page.GetTuple(&result, schema.get(), nullptr, nullptr));
+    const Field *name = result.GetField(1);
+    ASSERT_EQ(names[slot], std::string(name->GetData(), name->GetLength()));
+  }
+}
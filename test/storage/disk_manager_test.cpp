@@ -1,6 +1,13 @@
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <future>
+#include <sys/stat.h>
 #include <unordered_set>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "page/page.h"
 #include "storage/disk_manager.h"
 
 TEST(DiskManagerTest, BitMapPageTest) {
@@ -55,4 +62,242 @@ TEST(DiskManagerTest, FreePageAllocationTest) {
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 2, meta_page->GetExtentUsedPage(0));
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 3, meta_page->GetExtentUsedPage(1));
   remove(db_name.c_str());
-}
\ No newline at end of file
+}
+
+TEST(DiskManagerTest, PageReadWriteTest) {
+  std::string db_name = "disk_rw_test.db";
+  for (bool direct_io : {false, true}) {
+    remove(db_name.c_str());
+    auto *disk_mgr = new DiskManager(db_name, direct_io);
+    char buf[PAGE_SIZE];
+    // Scenario: reading beyond the end of file gives a zeroed page.
+    memset(buf, 1, PAGE_SIZE);
+    disk_mgr->ReadPage(10, buf);
+    for (char c : buf) {
+      ASSERT_EQ(0, c);
+    }
+    // Scenario: unaligned buffers are accepted in both modes.
+    for (page_id_t page_id = 0; page_id < 20; page_id++) {
+      memset(buf, 'a' + page_id, PAGE_SIZE);
+      disk_mgr->WritePage(page_id, buf);
+    }
+    Page page;
+    disk_mgr->ReadPage(7, page.GetData());
+    EXPECT_EQ('a' + 7, page.GetData()[PAGE_SIZE - 1]);
+    disk_mgr->Close();
+    delete disk_mgr;
+
+    // Scenario: the cached file size is initialized from the existing file on reopen.
+    disk_mgr = new DiskManager(db_name, direct_io);
+    for (page_id_t page_id = 0; page_id < 20; page_id++) {
+      disk_mgr->ReadPage(page_id, buf);
+      ASSERT_EQ('a' + page_id, buf[0]);
+      ASSERT_EQ('a' + page_id, buf[PAGE_SIZE - 1]);
+    }
+    delete disk_mgr;
+  }
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, AsyncReadWriteTest) {
+  std::string db_name = "disk_async_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  const int num_pages = 100;
+  std::vector<std::vector<char>> pages(num_pages, std::vector<char>(PAGE_SIZE));
+  std::vector<std::pair<page_id_t, const char *>> batch;
+  // submit in reverse order, the disk manager is free to reorder the batch
+  for (page_id_t page_id = num_pages - 1; page_id >= 0; page_id--) {
+    memset(pages[page_id].data(), 'a' + page_id % 26, PAGE_SIZE);
+    batch.emplace_back(page_id, pages[page_id].data());
+  }
+  EXPECT_EQ(std::vector<bool>(num_pages, true), disk_mgr->WritePagesAsync(std::move(batch)).get());
+  EXPECT_TRUE(disk_mgr->WritePagesAsync({}).get().empty());
+
+  std::vector<std::vector<char>> read_pages(num_pages, std::vector<char>(PAGE_SIZE));
+  std::vector<std::future<bool>> reads;
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    reads.push_back(disk_mgr->ReadPageAsync(page_id, read_pages[page_id].data()));
+  }
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    ASSERT_TRUE(reads[page_id].get());
+    ASSERT_EQ(pages[page_id], read_pages[page_id]);
+  }
+
+  // Scenario: close waits for requests still in flight.
+  char buf[PAGE_SIZE];
+  auto pending = disk_mgr->ReadPageAsync(num_pages - 1, buf);
+  disk_mgr->Close();
+  EXPECT_EQ(std::future_status::ready, pending.wait_for(std::chrono::seconds(0)));
+  EXPECT_EQ('a' + (num_pages - 1) % 26, buf[0]);
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, BitMapPageHintTest) {
+  char buf[PAGE_SIZE];
+  memset(buf, 0, PAGE_SIZE);
+  auto *bitmap = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(buf);
+  const uint32_t num_pages = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+  uint32_t ofs;
+  for (uint32_t i = 0; i < num_pages; i++) {
+    ASSERT_TRUE(bitmap->AllocatePage(ofs));
+    ASSERT_EQ(i, ofs);
+  }
+  // Scenario: freed pages are handed out again lowest first, across word boundaries.
+  const uint32_t freed[] = {num_pages - 1, 200, 63, 64, 127, 0};
+  for (auto page : freed) {
+    ASSERT_TRUE(bitmap->DeAllocatePage(page));
+  }
+  const uint32_t expected[] = {0, 63, 64, 127, 200, num_pages - 1};
+  for (auto page : expected) {
+    ASSERT_TRUE(bitmap->AllocatePage(ofs));
+    ASSERT_EQ(page, ofs);
+  }
+  ASSERT_FALSE(bitmap->AllocatePage(ofs));
+}
+
+/**
+ * Counts the pages read from and written to disk
+ */
+class CountingDiskManager : public DiskManager {
+public:
+  explicit CountingDiskManager(const std::string &db_file) : DiskManager(db_file) {}
+
+  int num_io_{0};
+
+protected:
+  bool ReadPhysicalPage(physical_page_id_t physical_page_id, char *page_data) override {
+    num_io_++;
+    return DiskManager::ReadPhysicalPage(physical_page_id, page_data);
+  }
+
+  bool WritePhysicalPage(physical_page_id_t physical_page_id, const char *page_data) override {
+    num_io_++;
+    return DiskManager::WritePhysicalPage(physical_page_id, page_data);
+  }
+};
+
+TEST(DiskManagerTest, BitmapCacheTest) {
+  std::string db_name = "disk_bitmap_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new CountingDiskManager(db_name);
+  // Scenario: once the bitmap of an extent is cached, allocation needs no I/O.
+  const page_id_t num_pages = DiskManager::BITMAP_SIZE + 100;
+  for (page_id_t i = 0; i < num_pages; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+  disk_mgr->DeAllocatePage(10);
+  EXPECT_TRUE(disk_mgr->IsPageFree(10));
+  EXPECT_EQ(10, disk_mgr->AllocatePage());
+  EXPECT_LE(disk_mgr->num_io_, 2);
+  disk_mgr->DeAllocatePage(DiskManager::BITMAP_SIZE + 5);
+  disk_mgr->Close();
+  delete disk_mgr;
+
+  // Scenario: bitmaps and the meta page are written back on close.
+  auto *reopened = new DiskManager(db_name);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(reopened->GetMetaData());
+  EXPECT_EQ(2, meta_page->GetExtentNums());
+  EXPECT_EQ(num_pages - 1, meta_page->GetAllocatedPages());
+  EXPECT_FALSE(reopened->IsPageFree(10));
+  EXPECT_TRUE(reopened->IsPageFree(DiskManager::BITMAP_SIZE + 5));
+  EXPECT_EQ(DiskManager::BITMAP_SIZE + 5, reopened->AllocatePage());
+  EXPECT_EQ(num_pages, reopened->AllocatePage());
+  delete reopened;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, ExtentReservationTest) {
+  std::string db_name = "disk_reservation_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  const auto run_size = static_cast<page_id_t>(BitmapPage<PAGE_SIZE>::RUN_SIZE);
+  const extent_owner_t heap = DiskFileMetaPage::TableHeapOwner(0);
+  const extent_owner_t index = DiskFileMetaPage::IndexOwner(0);
+
+  // Scenario: interleaved allocations of two owners still give each of them contiguous pages.
+  EXPECT_EQ(0, disk_mgr->AllocatePage());
+  std::vector<page_id_t> heap_pages, index_pages;
+  for (int i = 0; i < run_size + 10; i++) {
+    heap_pages.push_back(disk_mgr->AllocatePage(heap));
+    index_pages.push_back(disk_mgr->AllocatePage(index));
+  }
+  for (int i = 1; i < run_size + 10; i++) {
+    if (i % run_size != 0) {
+      EXPECT_EQ(heap_pages[i - 1] + 1, heap_pages[i]);
+      EXPECT_EQ(index_pages[i - 1] + 1, index_pages[i]);
+    }
+  }
+  EXPECT_EQ(run_size, heap_pages[0]);
+  EXPECT_EQ(2 * run_size, index_pages[0]);
+
+  // Scenario: unreserved allocations skip reserved runs, but may use the rest of the first run.
+  EXPECT_EQ(1, disk_mgr->AllocatePage());
+  disk_mgr->DeAllocatePage(heap_pages[5]);
+  EXPECT_EQ(2, disk_mgr->AllocatePage());
+  EXPECT_EQ(heap_pages[run_size + 10 - 1] + 1, disk_mgr->AllocatePage(heap));
+  disk_mgr->Close();
+  delete disk_mgr;
+
+  // Scenario: reservations are persisted in the meta page.
+  disk_mgr = new DiskManager(db_name);
+  EXPECT_EQ(index_pages[run_size + 10 - 1] + 1, disk_mgr->AllocatePage(index));
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, SegmentFileTest) {
+  std::string db_name = "disk_segment_test.db";
+  std::string segment_name = db_name + ".1";
+  remove(db_name.c_str());
+  remove(segment_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  EXPECT_EQ(1, disk_mgr->GetNumSegments());
+
+  // Scenario: pages past the first segment are stored in the next segment file.
+  const page_id_t page_id = DiskManager::PAGES_PER_SEGMENT + 3;
+  char data[PAGE_SIZE], buf[PAGE_SIZE];
+  memset(data, 0, PAGE_SIZE);
+  strcpy(data, "segment 1");
+  disk_mgr->WritePage(page_id, data);
+  disk_mgr->ReadPage(page_id, buf);
+  EXPECT_EQ(0, memcmp(data, buf, PAGE_SIZE));
+  struct stat segment_stat;
+  ASSERT_EQ(0, stat(segment_name.c_str(), &segment_stat));
+  EXPECT_LT(segment_stat.st_size, 16 * PAGE_SIZE);
+  disk_mgr->Close();
+  delete disk_mgr;
+
+  // Scenario: the page survives reopening the database.
+  disk_mgr = new DiskManager(db_name);
+  memset(buf, 0, PAGE_SIZE);
+  disk_mgr->ReadPage(page_id, buf);
+  EXPECT_EQ(0, memcmp(data, buf, PAGE_SIZE));
+  EXPECT_EQ(0, disk_mgr->AllocatePage());
+  delete disk_mgr;
+  remove(db_name.c_str());
+  remove(segment_name.c_str());
+}
+
+TEST(DiskManagerTest, FormatVersionTest) {
+  std::string db_name = "disk_version_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  EXPECT_EQ(0, disk_mgr->AllocatePage());
+  delete disk_mgr;
+
+  // Scenario: a file of the current format is opened again.
+  disk_mgr = new DiskManager(db_name);
+  EXPECT_FALSE(disk_mgr->IsPageFree(0));
+  delete disk_mgr;
+
+  // Scenario: a file of an older format is rejected.
+  uint32_t old_version = 0;
+  std::fstream file(db_name, std::ios::in | std::ios::out | std::ios::binary);
+  file.seekp(META_PAGE_ID * PAGE_SIZE + offsetof(DiskFileMetaPage, format_version_));
+  file.write(reinterpret_cast<const char *>(&old_version), sizeof(old_version));
+  file.close();
+  EXPECT_THROW(DiskManager old_disk_mgr(db_name), std::runtime_error);
+  remove(db_name.c_str());
+}
@@ -0,0 +1,67 @@
+#include <cstdio>
+#include <string>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/mmap_disk_manager.h"
+
+TEST(MmapDiskManagerTest, ReadWriteTest) {
+  std::string db_name = "mmap_disk_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new MmapDiskManager(db_name);
+  EXPECT_EQ(0, disk_mgr->GetMappedSize());
+  char buf[PAGE_SIZE];
+
+  // Scenario: writes past the end of the mapping extend it, across the bitmap page of the second extent.
+  const page_id_t pages[] = {0, 1, 100, static_cast<page_id_t>(DiskManager::BITMAP_SIZE) + 5};
+  for (auto page_id : pages) {
+    memset(buf, 'a' + page_id % 26, PAGE_SIZE);
+    disk_mgr->WritePage(page_id, buf);
+  }
+  EXPECT_LT(DiskManager::BITMAP_SIZE * PAGE_SIZE, disk_mgr->GetMappedSize());
+  for (auto page_id : pages) {
+    disk_mgr->ReadPage(page_id, buf);
+    ASSERT_EQ('a' + page_id % 26, buf[0]);
+    ASSERT_EQ('a' + page_id % 26, buf[PAGE_SIZE - 1]);
+  }
+  disk_mgr->ReadPage(2, buf);
+  EXPECT_EQ(0, buf[0]);
+  delete disk_mgr;
+
+  // Scenario: the file layout is the same as the one of the pread based disk manager.
+  auto *plain_disk_mgr = new DiskManager(db_name);
+  for (auto page_id : pages) {
+    plain_disk_mgr->ReadPage(page_id, buf);
+    ASSERT_EQ('a' + page_id % 26, buf[0]);
+  }
+  delete plain_disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(MmapDiskManagerTest, BufferPoolTest) {
+  std::string db_name = "mmap_bpm_test.db";
+  const size_t buffer_pool_size = 10;
+  remove(db_name.c_str());
+  auto *disk_mgr = new MmapDiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_mgr);
+
+  // Scenario: allocation goes through the bitmap pages of the mapped file.
+  for (int i = 0; i < 50; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(i, page_id);
+    snprintf(page->GetData(), PAGE_SIZE, "page-%d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  EXPECT_FALSE(bpm->IsPageFree(49));
+  for (int i = 0; i < 50; i++) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page-" + std::to_string(i), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+  delete bpm;
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
@@ -1,10 +1,15 @@
+#include <atomic>
+#include <numeric>
+#include <thread>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "record/field.h"
 #include "record/schema.h"
+#include "storage/parallel_table_scan.h"
 #include "storage/table_heap.h"
 #include "utils/utils.h"
 
@@ -54,3 +59,403 @@ TEST(TableHeapTest, TableHeapSampleTest) {
   }
 }
 
+
+class CountingBufferPoolManager : public BufferPoolManager {
+public:
+  using BufferPoolManager::BufferPoolManager;
+
+  Page *FetchPage(page_id_t page_id, BufferAccessStrategy *strategy = nullptr) override {
+    num_fetches_++;
+    if (page_id == fail_page_id_) {
+      return nullptr;
+    }
+    return BufferPoolManager::FetchPage(page_id, strategy);
+  }
+
+  std::atomic<size_t> num_fetches_{0};
+  std::atomic<page_id_t> fail_page_id_{INVALID_PAGE_ID};  // fetches of this page fail as if every frame was pinned
+};
+
+/**
+ * An empty table heap on a fresh database file, with an id and a name column and optionally an account column
+ */
+class TestTable {
+public:
+  explicit TestTable(bool with_account = false) {
+    remove(db_file_name.c_str());
+    disk_mgr_ = new DiskManager(db_file_name);
+    bpm_ = new CountingBufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+    std::vector<Column *> columns = {
+            ALLOC_COLUMN(heap_)("id", TypeId::kTypeInt, 0, false, false),
+            ALLOC_COLUMN(heap_)("name", TypeId::kTypeChar, 64, 1, true, false)
+    };
+    if (with_account) {
+      columns.push_back(ALLOC_COLUMN(heap_)("account", TypeId::kTypeFloat, 2, true, false));
+    }
+    schema_ = std::make_shared<Schema>(columns);
+    table_heap_ = TableHeap::Create(bpm_, schema_.get(), nullptr, nullptr, nullptr, &heap_);
+    memset(characters_, 'a', sizeof(characters_));
+  }
+
+  ~TestTable() {
+    delete bpm_;
+    delete disk_mgr_;
+    remove(db_file_name.c_str());
+  }
+
+  /** @return a row of the id and name columns, the name is characters_ */
+  Row MakeRow(int id) {
+    Fields fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, characters_, sizeof(characters_), true)};
+    return Row(fields);
+  }
+
+  /** @return rows with the ids 0 to row_nums - 1 */
+  std::vector<Row> MakeRows(int row_nums) {
+    std::vector<Row> rows;
+    for (int i = 0; i < row_nums; i++) {
+      rows.push_back(MakeRow(i));
+    }
+    return rows;
+  }
+
+  static std::string GetName(int id) { return "name" + std::to_string(id); }
+
+  /**
+   * Insert rows with the ids 0 to row_nums - 1 into a table with an account column, id i is named GetName(i)
+   * and has an account of i / 2
+   * @return the rids in insertion order
+   */
+  std::vector<RowId> InsertAccounts(int row_nums) {
+    std::vector<RowId> rids;
+    for (int i = 0; i < row_nums; i++) {
+      std::string name = GetName(i);
+      Fields fields{Field(TypeId::kTypeInt, i),
+                    Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true),
+                    Field(TypeId::kTypeFloat, i * 0.5f)};
+      Row row(fields);
+      EXPECT_TRUE(table_heap_->InsertTuple(row, nullptr));
+      rids.push_back(row.GetRowId());
+    }
+    return rids;
+  }
+
+  SimpleMemHeap heap_;
+  DiskManager *disk_mgr_;
+  CountingBufferPoolManager *bpm_;
+  std::shared_ptr<Schema> schema_;
+  TableHeap *table_heap_;
+  char characters_[64];
+};
+
+TEST(TableHeapTest, FreeSpaceMapTest) {
+  TestTable table;
+  TableHeap *table_heap = table.table_heap_;
+  auto insert = [&](int i) {
+    Row row = table.MakeRow(i);
+    EXPECT_TRUE(table_heap->InsertTuple(row, nullptr));
+    return row.GetRowId();
+  };
+
+  // Scenario: the cost of an insert does not grow with the number of pages.
+  const int row_nums = 20000;
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    rids.push_back(insert(i));
+  }
+  ASSERT_GT(rids.back().GetPageId() - rids.front().GetPageId(), 200);
+  table.bpm_->num_fetches_ = 0;
+  for (int i = 0; i < 100; i++) {
+    insert(row_nums + i);
+  }
+  EXPECT_LE(table.bpm_->num_fetches_.load(), 100u * 4);
+
+  // Scenario: space freed on an early page is reused.
+  // Two tuples are freed, the map rounds free space down to whole buckets.
+  RowId freed = rids[10];
+  for (auto rid : {rids[10], rids[11]}) {
+    ASSERT_TRUE(table_heap->MarkDelete(rid, nullptr));
+    table_heap->ApplyDelete(rid, nullptr);
+  }
+  EXPECT_EQ(freed.GetPageId(), insert(-1).GetPageId());
+
+  // Scenario: the map is found again when the heap is reopened.
+  TableHeap *reopened = TableHeap::Create(table.bpm_, table_heap->GetFirstPageId(), table.schema_.get(), nullptr,
+                                          nullptr, &table.heap_);
+  EXPECT_EQ(table_heap->GetFreeSpaceMapPageId(), reopened->GetFreeSpaceMapPageId());
+}
+
+TEST(TableHeapTest, BulkInsertTest) {
+  TestTable table;
+  TableHeap *table_heap = table.table_heap_;
+  const int row_nums = 5000;
+  std::vector<Row> rows = table.MakeRows(row_nums);
+
+  // Scenario: every page is fetched about once for the whole batch.
+  table.bpm_->num_fetches_ = 0;
+  ASSERT_TRUE(table_heap->InsertTuples(rows, nullptr));
+  std::unordered_set<page_id_t> pages;
+  for (auto &row : rows) {
+    pages.insert(row.GetRowId().GetPageId());
+  }
+  EXPECT_LE(table.bpm_->num_fetches_.load(), 3 * pages.size());
+
+  // Scenario: the rows can be read back at their rids.
+  for (int i = 0; i < row_nums; i++) {
+    Row row(rows[i].GetRowId());
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, i)));
+  }
+}
+
+TEST(TableHeapTest, ConcurrentInsertTest) {
+  TestTable table;
+  TableHeap *table_heap = table.table_heap_;
+
+  // Scenario: single inserts, bulk inserts and deletes of several writers interleave without losing a row.
+  const int num_threads = 4;
+  const int row_nums = 2000;
+  std::vector<std::vector<RowId>> rids(num_threads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      std::vector<Row> rows;
+      for (int i = 0; i < row_nums; i++) {
+        rows.push_back(table.MakeRow(t * row_nums + i));
+        if (t % 2 == 1) {
+          continue;
+        }
+        ASSERT_TRUE(table_heap->InsertTuple(rows.back(), nullptr));
+        rids[t].push_back(rows.back().GetRowId());
+        // every tenth row is deleted again, its space is reused by the other writers
+        if (i % 10 == 0) {
+          ASSERT_TRUE(table_heap->MarkDelete(rids[t].back(), nullptr));
+          table_heap->ApplyDelete(rids[t].back(), nullptr);
+          rids[t].pop_back();
+        }
+      }
+      if (t % 2 == 1) {
+        for (size_t i = 0; i < rows.size(); i += 100) {
+          std::vector<Row> batch(rows.begin() + i, rows.begin() + i + 100);
+          ASSERT_TRUE(table_heap->InsertTuples(batch, nullptr));
+          for (auto &row : batch) {
+            rids[t].push_back(row.GetRowId());
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::unordered_set<int64_t> expected;
+  for (auto &thread_rids : rids) {
+    for (auto &rid : thread_rids) {
+      ASSERT_TRUE(expected.insert(rid.Get()).second);
+    }
+  }
+  size_t scanned = 0;
+  table_heap->Scan([&](const RowView &view) {
+    EXPECT_EQ(1u, expected.count(view.GetRowId().Get()));
+    scanned++;
+    return true;
+  }, nullptr);
+  EXPECT_EQ(expected.size(), scanned);
+  EXPECT_TRUE(table.bpm_->CheckAllUnpinned());
+}
+
+TEST(TableHeapTest, RowViewScanTest) {
+  TestTable table(true);
+  TableHeap *table_heap = table.table_heap_;
+  const int row_nums = 1000;
+  table.InsertAccounts(row_nums);
+
+  // Scenario: columns are decoded in place in any order.
+  int count = 0;
+  table_heap->Scan([&](const RowView &view) {
+    int id = view.GetInt(0);
+    std::string expected_name = TestTable::GetName(id);
+    uint32_t len;
+    const char *name = view.GetChars(1, &len);
+    EXPECT_EQ(expected_name, std::string(name, len));
+    EXPECT_FLOAT_EQ(id * 0.5f, view.GetFloat(2));
+    EXPECT_EQ(CmpBool::kTrue, view.GetField(1).CompareEquals(
+            Field(TypeId::kTypeChar, const_cast<char *>(expected_name.c_str()), expected_name.size(), false)));
+    Row row(RowId{});
+    view.ToRow(&row);
+    EXPECT_EQ(view.GetRowId().Get(), row.GetRowId().Get());
+    EXPECT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, id)));
+    count++;
+    return true;
+  }, nullptr);
+  EXPECT_EQ(row_nums, count);
+
+  // Scenario: the visitor stops the scan.
+  count = 0;
+  table_heap->Scan([&](const RowView &) { return ++count < 10; }, nullptr);
+  EXPECT_EQ(10, count);
+}
+
+TEST(TableHeapTest, TableIteratorTest) {
+  TestTable table;
+  TableHeap *table_heap = table.table_heap_;
+  const int row_nums = 2000;
+  std::vector<Row> rows = table.MakeRows(row_nums);
+  ASSERT_TRUE(table_heap->InsertTuples(rows, nullptr));
+  std::unordered_set<page_id_t> pages;
+  for (auto &row : rows) {
+    pages.insert(row.GetRowId().GetPageId());
+  }
+
+  // Scenario: rows come back in insertion order, pages are fetched at page boundaries only.
+  table.bpm_->num_fetches_ = 0;
+  int i = 0;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter, ++i) {
+    ASSERT_EQ(rows[i].GetRowId().Get(), iter->GetRowId().Get());
+    ASSERT_EQ(CmpBool::kTrue, iter->GetField(0)->CompareEquals(Field(TypeId::kTypeInt, i)));
+  }
+  EXPECT_EQ(row_nums, i);
+  EXPECT_LE(table.bpm_->num_fetches_.load(), 2 * pages.size() + 2);
+
+  // Scenario: rows of an iterator come from the arena of the statement, the memory of a row is reused by the next.
+  ArenaMemHeap statement_heap;
+  i = 0;
+  for (auto iter = table_heap->Begin(nullptr, &statement_heap); iter != table_heap->End(); ++iter, ++i) {
+    Field *name = iter->GetField(1);
+    ASSERT_EQ(0, memcmp(table.characters_, name->GetData(), name->GetLength()));
+  }
+  EXPECT_EQ(row_nums, i);
+  EXPECT_LE(statement_heap.GetCapacity(), static_cast<size_t>(ROW_ARENA_CHUNK_SIZE));
+
+  // Scenario: the iterators a post increment leaves behind give their arenas back to the statement.
+  i = 0;
+  for (auto iter = table_heap->Begin(nullptr, &statement_heap); iter != table_heap->End(); iter++, ++i) {
+  }
+  EXPECT_EQ(row_nums, i);
+  EXPECT_LE(statement_heap.GetCapacity(), static_cast<size_t>(ROW_ARENA_CHUNK_SIZE));
+
+  // Scenario: a post increment returns the row it moved away from, without copying it.
+  {
+    auto iter = table_heap->Begin(nullptr);
+    const Row *row = &*iter;
+    Field *field = iter->GetField(0);
+    auto old = iter++;
+    ASSERT_EQ(row, &*old);
+    ASSERT_EQ(field, old->GetField(0));
+    ASSERT_EQ(rows[0].GetRowId().Get(), old->GetRowId().Get());
+    ASSERT_EQ(CmpBool::kTrue, old->GetField(0)->CompareEquals(Field(TypeId::kTypeInt, 0)));
+    ASSERT_EQ(rows[1].GetRowId().Get(), iter->GetRowId().Get());
+  }
+
+  // Scenario: an iterator that was moved from is at the end, and a copy of it too.
+  {
+    auto iter = table_heap->Begin(nullptr);
+    auto moved = std::move(iter);
+    EXPECT_TRUE(iter == table_heap->End());
+    EXPECT_FALSE(moved == table_heap->End());
+    TableIterator copy(iter);
+    EXPECT_TRUE(copy == table_heap->End());
+    iter = moved;
+    ASSERT_EQ(rows[0].GetRowId().Get(), iter->GetRowId().Get());
+  }
+
+  // Scenario: the table can be updated while it is iterated.
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+    ASSERT_TRUE(table_heap->MarkDelete(iter->GetRowId(), nullptr));
+  }
+  EXPECT_TRUE(table.bpm_->CheckAllUnpinned());
+}
+
+TEST(TableHeapTest, ScanBatchTest) {
+  TestTable table(true);
+  TableHeap *table_heap = table.table_heap_;
+  const int row_nums = 1000;
+  std::vector<RowId> rids = table.InsertAccounts(row_nums);
+  table_heap->MarkDelete(rids[7], nullptr);
+  table_heap->ApplyDelete(rids[7], nullptr);
+
+  // Scenario: batches smaller than a page continue where the previous one stopped, deleted tuples are skipped.
+  ColumnBatch batch(table.schema_.get(), 64);
+  BatchScanCursor cursor = table_heap->BeginBatchScan();
+  int expected = 0;
+  while (true) {
+    ASSERT_TRUE(table_heap->ScanBatch(&cursor, &batch, nullptr));
+    if (batch.GetSize() == 0) {
+      break;
+    }
+    ASSERT_EQ(batch.GetSize(), batch.GetSelectedCount());
+    for (uint32_t i = 0; i < batch.GetSize(); i++, expected++) {
+      if (expected == 7) {
+        expected++;
+      }
+      ASSERT_EQ(expected, batch.GetColumn(0).GetInts()[i]);
+      ASSERT_EQ(rids[expected].Get(), batch.GetRowId(i).Get());
+      uint32_t len;
+      const char *name = batch.GetColumn(1).GetChars(i, &len);
+      ASSERT_EQ(TestTable::GetName(expected), std::string(name, len));
+      ASSERT_FLOAT_EQ(expected * 0.5f, batch.GetColumn(2).GetFloats()[i]);
+    }
+  }
+  EXPECT_EQ(row_nums, expected);
+
+  // Scenario: a page that can not be fetched fails the scan instead of ending it, the scan can be resumed.
+  cursor = table_heap->BeginBatchScan();
+  table.bpm_->fail_page_id_ = table_heap->GetFirstPageId();
+  EXPECT_FALSE(table_heap->ScanBatch(&cursor, &batch, nullptr));
+  EXPECT_EQ(table_heap->GetFirstPageId(), cursor.page_id_);
+  table.bpm_->fail_page_id_ = INVALID_PAGE_ID;
+  ASSERT_TRUE(table_heap->ScanBatch(&cursor, &batch, nullptr));
+  EXPECT_EQ(0, batch.GetColumn(0).GetInts()[0]);
+  EXPECT_TRUE(table.bpm_->CheckAllUnpinned());
+}
+
+TEST(TableHeapTest, ParallelTableScanTest) {
+  TestTable table;
+  TableHeap *table_heap = table.table_heap_;
+  const int row_nums = 10000;
+  std::vector<Row> rows = table.MakeRows(row_nums);
+  ASSERT_TRUE(table_heap->InsertTuples(rows, nullptr));
+
+  // Scenario: the page directory lists the chain in order.
+  std::vector<page_id_t> page_ids;
+  ASSERT_TRUE(table_heap->GetPageIds(&page_ids));
+  EXPECT_EQ(table_heap->GetFirstPageId(), page_ids.front());
+  EXPECT_EQ(rows.back().GetRowId().GetPageId(), page_ids.back());
+
+  // Scenario: every tuple is seen exactly once, summed per worker.
+  ParallelTableScan scan(table_heap, 4, 4);
+  std::vector<int64_t> sums(scan.GetNumWorkers(), 0);
+  std::vector<int> counts(scan.GetNumWorkers(), 0);
+  ASSERT_TRUE(scan.Execute([&](size_t worker_id, ColumnBatch &batch) {
+    for (uint32_t i = 0; i < batch.GetSelectedCount(); i++) {
+      sums[worker_id] += batch.GetColumn(0).GetInts()[batch.GetSelection()[i]];
+    }
+    counts[worker_id] += batch.GetSelectedCount();
+  }, nullptr));
+  EXPECT_EQ(row_nums, std::accumulate(counts.begin(), counts.end(), 0));
+  EXPECT_EQ(int64_t(row_nums) * (row_nums - 1) / 2, std::accumulate(sums.begin(), sums.end(), int64_t(0)));
+
+  // Scenario: a page that can not be fetched fails the scan.
+  table.bpm_->fail_page_id_ = page_ids[page_ids.size() / 2];
+  EXPECT_FALSE(scan.Execute([](size_t, ColumnBatch &) {}, nullptr));
+  table.bpm_->fail_page_id_ = INVALID_PAGE_ID;
+  EXPECT_TRUE(table.bpm_->CheckAllUnpinned());
+
+  // Scenario: a page that can not be added to the free space map is not linked into the chain.
+  auto last_page = static_cast<TablePage *>(table.bpm_->FetchPage(page_ids.back()));
+  table.bpm_->fail_page_id_ = last_page->GetFreeSpaceMapPageId();
+  table.bpm_->UnpinPage(page_ids.back(), false);
+  std::vector<Row> more = table.MakeRows(200);
+  EXPECT_FALSE(table_heap->InsertTuples(more, nullptr));
+  table.bpm_->fail_page_id_ = INVALID_PAGE_ID;
+  ASSERT_TRUE(table_heap->InsertTuples(more, nullptr));
+  ASSERT_TRUE(table_heap->GetPageIds(&page_ids));
+  std::vector<page_id_t> chain;
+  for (auto page_id = table_heap->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    chain.push_back(page_id);
+    auto page = static_cast<TablePage *>(table.bpm_->FetchPage(page_id));
+    page_id = page->GetNextPageId();
+    table.bpm_->UnpinPage(chain.back(), false);
+  }
+  EXPECT_EQ(chain, page_ids);
+  EXPECT_TRUE(table.bpm_->CheckAllUnpinned());
+}
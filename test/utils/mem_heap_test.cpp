@@ -0,0 +1,77 @@
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "utils/mem_heap.h"
+
+TEST(MemHeapTest, ArenaAllocateTest) {
+  ArenaMemHeap heap(256);
+  ASSERT_EQ(0u, heap.GetCapacity());
+  // allocations are aligned and do not overlap
+  std::vector<char *> bufs;
+  for (size_t i = 1; i <= 100; i++) {
+    auto buf = static_cast<char *>(heap.Allocate(i));
+    ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(buf) % alignof(std::max_align_t));
+    memset(buf, static_cast<int>(i), i);
+    bufs.push_back(buf);
+  }
+  for (size_t i = 1; i <= 100; i++) {
+    for (size_t j = 0; j < i; j++) {
+      ASSERT_EQ(static_cast<char>(i), bufs[i - 1][j]);
+    }
+  }
+  // a large allocation gets a chunk of its own
+  auto large = static_cast<char *>(heap.Allocate(1000));
+  memset(large, 1, 1000);
+  ASSERT_GE(heap.GetCapacity(), 1000u);
+}
+
+TEST(MemHeapTest, ArenaResetTest) {
+  ArenaMemHeap heap(256);
+  void *first = heap.Allocate(16);
+  auto mark = heap.GetMark();
+  void *second = heap.Allocate(16);
+  for (int i = 0; i < 100; i++) {
+    heap.Allocate(64);
+  }
+  size_t capacity = heap.GetCapacity();
+  // the memory after the mark is handed out again, without new chunks
+  heap.ResetTo(mark);
+  ASSERT_EQ(second, heap.Allocate(16));
+  for (int i = 0; i < 100; i++) {
+    heap.Allocate(64);
+  }
+  ASSERT_EQ(capacity, heap.GetCapacity());
+  heap.Reset();
+  ASSERT_EQ(first, heap.Allocate(16));
+  ASSERT_EQ(capacity, heap.GetCapacity());
+}
+
+TEST(MemHeapTest, ArenaChildTest) {
+  ArenaMemHeap heap(256);
+  heap.Allocate(16);
+  ArenaMemHeap *kept = heap.CreateChild(256);
+  kept->Allocate(16);
+  size_t capacity = heap.GetCapacity();
+  ASSERT_EQ(512u, capacity);
+  // children created after the mark are released with the memory after it
+  auto mark = heap.GetMark();
+  ArenaMemHeap *child = heap.CreateChild(256);
+  child->Allocate(1024);
+  child->CreateChild(256)->Allocate(16);
+  ASSERT_EQ(capacity + 1024 + 256, heap.GetCapacity());
+  heap.ResetTo(mark);
+  ASSERT_EQ(capacity, heap.GetCapacity());
+  // a child released early gives its memory back before the parent is reset, marks are not affected
+  child = heap.CreateChild(256);
+  child->Allocate(16);
+  mark = heap.GetMark();
+  heap.ReleaseChild(kept);
+  heap.ReleaseChild(child);
+  ASSERT_EQ(256u, heap.GetCapacity());
+  heap.CreateChild(256)->Allocate(16);
+  heap.ResetTo(mark);
+  ASSERT_EQ(256u, heap.GetCapacity());
+  heap.CreateChild(256)->Allocate(16);
+  heap.Reset();
+  ASSERT_EQ(256u, heap.GetCapacity());
+}